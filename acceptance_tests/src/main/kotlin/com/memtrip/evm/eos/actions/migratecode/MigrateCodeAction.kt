@@ -0,0 +1,48 @@
+package com.memtrip.evm.eos.actions.migratecode
+
+import com.memtrip.eos.abi.writer.compression.CompressionType
+import com.memtrip.eos.chain.actions.ChainResponse
+import com.memtrip.eos.chain.actions.transaction.ChainTransaction
+import com.memtrip.eos.chain.actions.transaction.TransactionContext
+import com.memtrip.eos.chain.actions.transaction.abi.ActionAbi
+import com.memtrip.eos.chain.actions.transaction.abi.TransactionAuthorizationAbi
+import com.memtrip.eos.http.rpc.ChainApi
+import com.memtrip.eos.http.rpc.model.transaction.response.TransactionCommitted
+import com.memtrip.evm.eos.AbiBinaryGenEvmWriter
+import com.memtrip.evm.eos.Config
+import com.memtrip.evm.eos.actions.migratecode.abi.MigrateCodeArgs
+import com.memtrip.evm.eos.actions.migratecode.abi.MigrateCodeBody
+import io.reactivex.Single
+
+class MigrateCodeAction(chainApi: ChainApi) : ChainTransaction(chainApi) {
+
+    fun pushTransaction(
+        limit: Long,
+        transactionContext: TransactionContext
+    ): Single<ChainResponse<TransactionCommitted>> {
+        return push(
+            transactionContext.expirationDate,
+            listOf(
+                ActionAbi(
+                    Config.CONTRACT_ACCOUNT_NAME,
+                    "migratecode",
+                    listOf(
+                        TransactionAuthorizationAbi(
+                            transactionContext.authorizingAccountName,
+                            "active")
+                    ),
+                    bin(limit)
+                )
+            ),
+            transactionContext.authorizingPrivateKey
+        )
+    }
+
+    private fun bin(limit: Long): String {
+        return AbiBinaryGenEvmWriter(CompressionType.NONE).squishMigrateCodeBody(
+            MigrateCodeBody(
+                MigrateCodeArgs(limit)
+            )
+        ).toHex()
+    }
+}
\ No newline at end of file
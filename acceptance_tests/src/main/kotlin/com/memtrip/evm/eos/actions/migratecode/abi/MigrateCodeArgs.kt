@@ -0,0 +1,13 @@
+package com.memtrip.evm.eos.actions.migratecode.abi
+
+import com.memtrip.eos.abi.writer.Abi
+import com.memtrip.eos.abi.writer.LongCompress
+
+@Abi
+data class MigrateCodeArgs(
+    val limit: Long
+) {
+
+    val getLimit: Long
+        @LongCompress get() = limit
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+package com.memtrip.evm.eos.actions.migratecode.abi
+
+import com.memtrip.eos.abi.writer.Abi
+import com.memtrip.eos.abi.writer.ChildCompress
+
+@Abi
+data class MigrateCodeBody(
+    val args: MigrateCodeArgs
+) {
+
+    val getArgs: MigrateCodeArgs
+        @ChildCompress get() = args
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+package com.memtrip.evm.eos.actions.migratestate.abi
+
+import com.memtrip.eos.abi.writer.Abi
+import com.memtrip.eos.abi.writer.ChildCompress
+
+@Abi
+data class MigrateStateBody(
+    val args: MigrateStateArgs
+) {
+
+    val getArgs: MigrateStateArgs
+        @ChildCompress get() = args
+}
\ No newline at end of file
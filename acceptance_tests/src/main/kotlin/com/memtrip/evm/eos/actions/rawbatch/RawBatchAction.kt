@@ -0,0 +1,52 @@
+package com.memtrip.evm.eos.actions.rawbatch
+
+import com.memtrip.eos.abi.writer.compression.CompressionType
+import com.memtrip.eos.chain.actions.ChainResponse
+import com.memtrip.eos.chain.actions.transaction.ChainTransaction
+import com.memtrip.eos.chain.actions.transaction.TransactionContext
+import com.memtrip.eos.chain.actions.transaction.abi.ActionAbi
+import com.memtrip.eos.chain.actions.transaction.abi.TransactionAuthorizationAbi
+import com.memtrip.eos.http.rpc.ChainApi
+import com.memtrip.eos.http.rpc.model.transaction.response.TransactionCommitted
+import com.memtrip.evm.eos.AbiBinaryGenEvmWriter
+import com.memtrip.evm.eos.Config
+import com.memtrip.evm.eos.actions.rawbatch.abi.RawBatchArgs
+import com.memtrip.evm.eos.actions.rawbatch.abi.RawBatchBody
+import io.reactivex.Single
+
+class RawBatchAction(chainApi: ChainApi) : ChainTransaction(chainApi) {
+
+    fun pushTransaction(
+        from: String,
+        txs: List<String>,
+        transactionContext: TransactionContext
+    ): Single<ChainResponse<TransactionCommitted>> {
+        return push(
+            transactionContext.expirationDate,
+            listOf(
+                ActionAbi(
+                    Config.CONTRACT_ACCOUNT_NAME,
+                    "rawbatch",
+                    listOf(
+                        TransactionAuthorizationAbi(
+                            transactionContext.authorizingAccountName,
+                            "active")
+                    ),
+                    bin(from, txs)
+                )
+            ),
+            transactionContext.authorizingPrivateKey
+        )
+    }
+
+    private fun bin(
+        from: String,
+        txs: List<String>
+    ): String {
+        return AbiBinaryGenEvmWriter(CompressionType.NONE).squishRawBatchBody(
+            RawBatchBody(
+                RawBatchArgs(from, txs)
+            )
+        ).toHex()
+    }
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+package com.memtrip.evm.eos.actions.rawbatch.abi
+
+import com.memtrip.eos.abi.writer.Abi
+import com.memtrip.eos.abi.writer.AccountNameCompress
+import com.memtrip.eos.abi.writer.HexCollectionCompress
+
+@Abi
+data class RawBatchArgs(
+    val from: String,
+    val txs: List<String>
+) {
+
+    val getFrom: String
+        @AccountNameCompress get() = from
+
+    val getTxs: List<String>
+        @HexCollectionCompress get() = txs
+}
\ No newline at end of file
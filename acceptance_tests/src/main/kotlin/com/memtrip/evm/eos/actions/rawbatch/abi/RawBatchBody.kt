@@ -0,0 +1,13 @@
+package com.memtrip.evm.eos.actions.rawbatch.abi
+
+import com.memtrip.eos.abi.writer.Abi
+import com.memtrip.eos.abi.writer.ChildCompress
+
+@Abi
+data class RawBatchBody(
+    val args: RawBatchArgs
+) {
+
+    val getArgs: RawBatchArgs
+        @ChildCompress get() = args
+}
\ No newline at end of file
@@ -95,6 +95,20 @@ abstract class EvmContract(
         outputParameters: List<TypeReference<*>>,
         sender: EvmSender
     ): Single<ChainResponse<TransactionCommitted>> {
+        return rawAction.pushTransaction(
+            sender.eosAccountName,
+            signMethod(name, inputParameters, outputParameters, sender),
+            sender.accountIdentifier,
+            TransactionContext(sender.eosAccountName, sender.privateKey, transactionDefaultExpiry())
+        )
+    }
+
+    fun signMethod(
+        name: String,
+        inputParameters: List<Type<*>>,
+        outputParameters: List<TypeReference<*>>,
+        sender: EvmSender
+    ): String {
         val abiEncodedBytes = encodeFunctionArgs(name, inputParameters, outputParameters)
 
         val callTransaction = EthereumTransaction(
@@ -106,12 +120,7 @@ abstract class EvmContract(
             parentAddress
         )
 
-        return rawAction.pushTransaction(
-            sender.eosAccountName,
-            callTransaction.sign(sender.ethAccount).signedTransaction.toHexString(),
-            sender.accountIdentifier,
-            TransactionContext(sender.eosAccountName, sender.privateKey, transactionDefaultExpiry())
-        )
+        return callTransaction.sign(sender.ethAccount).signedTransaction.toHexString()
     }
 
     private fun encodeFunctionArgs(
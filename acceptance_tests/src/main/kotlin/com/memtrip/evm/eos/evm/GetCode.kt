@@ -30,7 +30,7 @@ class GetCode(
             GetTableRows(
                 Config.CONTRACT_ACCOUNT_NAME,
                 Config.CONTRACT_ACCOUNT_NAME,
-                "accountcode",
+                "codeaccounts",
                 "owneraddress",
                 true,
                 1,
@@ -61,7 +61,7 @@ class GetCode(
             GetTableRows(
                 Config.CONTRACT_ACCOUNT_NAME,
                 Config.CONTRACT_ACCOUNT_NAME,
-                "accountcode",
+                "codeaccounts",
                 "owneraddress",
                 true,
                 100,
@@ -94,7 +94,7 @@ class GetCode(
             GetTableRows(
                 Config.CONTRACT_ACCOUNT_NAME,
                 Config.CONTRACT_ACCOUNT_NAME,
-                "accountcode",
+                "codeaccounts",
                 "codeaddress",
                 true,
                 100,
@@ -0,0 +1,74 @@
+package com.memtrip.evm.eos
+
+import com.memtrip.eos.chain.actions.transaction.TransactionContext
+import com.memtrip.eos.core.crypto.EosPrivateKey
+import com.memtrip.eos.http.rpc.Api
+import com.memtrip.evm.assertConsoleString
+import com.memtrip.evm.eos.actions.migratecode.MigrateCodeAction
+import com.memtrip.evm.eos.actions.migratestate.MigrateStateAction
+import com.memtrip.evm.eos.evm.EvmSender
+import com.memtrip.evm.eos.evm.contracts.misc.PublicMappingContract
+import com.memtrip.evm.ethereum.toHexString
+import okhttp3.OkHttpClient
+import okhttp3.logging.HttpLoggingInterceptor
+import org.junit.Assert.assertEquals
+import org.junit.Test
+import java.util.concurrent.TimeUnit
+
+class MigrateTest {
+
+    private val okHttpClient = OkHttpClient.Builder()
+        .addInterceptor(HttpLoggingInterceptor().setLevel(HttpLoggingInterceptor.Level.BODY))
+        .connectTimeout(10, TimeUnit.SECONDS)
+        .readTimeout(10, TimeUnit.SECONDS)
+        .writeTimeout(10, TimeUnit.SECONDS)
+        .build()
+
+    private val chainApi = Api(Config.CHAIN_API_BASE_URL, okHttpClient).chain
+
+    private val setupTransactions = SetupTransactions(chainApi)
+
+    private val migrateStateAction = MigrateStateAction(chainApi)
+
+    private val migrateCodeAction = MigrateCodeAction(chainApi)
+
+    private val contractPrivateKey = EosPrivateKey(Config.SEED_PRIVATE_KEY)
+
+    @Test
+    fun `Running migratestate before migratecode keeps contract storage`() {
+        // given
+        val (newAccountName, newAccountPrivateKey, newEthAccount) = setupTransactions.seed(17000)
+        val contract = PublicMappingContract(newAccountName, newAccountPrivateKey, newEthAccount)
+        val createContract = contract.createContract().blockingGet()
+        assertEquals(202, createContract.statusCode)
+
+        // when
+        val migrateState = migrateStateAction.pushTransaction(
+            500,
+            TransactionContext(Config.CONTRACT_ACCOUNT_NAME, contractPrivateKey, transactionDefaultExpiry())
+        ).blockingGet()
+        val migrateCode = migrateCodeAction.pushTransaction(
+            500,
+            TransactionContext(Config.CONTRACT_ACCOUNT_NAME, contractPrivateKey, transactionDefaultExpiry())
+        ).blockingGet()
+
+        // then
+        assertEquals(202, migrateState.statusCode)
+        assertEquals(202, migrateCode.statusCode)
+
+        // and when
+        val response = contract.get(
+            EvmSender(
+                2,
+                newEthAccount,
+                newAccountName,
+                newAccountPrivateKey,
+                contract.ownerAccountIdentifier.toHexString()
+            )
+        ).blockingGet()
+
+        // and then
+        assertEquals(202, response.statusCode)
+        response.assertConsoleString("return[000000000000000000000000000000000000000000000000000000000000002a]")
+    }
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+package com.memtrip.evm.eos
+
+import com.memtrip.eos.chain.actions.transaction.TransactionContext
+import com.memtrip.eos.http.rpc.Api
+import com.memtrip.evm.assertConsoleString
+import com.memtrip.evm.eos.actions.rawbatch.RawBatchAction
+import com.memtrip.evm.eos.evm.EvmSender
+import com.memtrip.evm.eos.evm.GetCode
+import com.memtrip.evm.eos.evm.contracts.misc.RevertStorageContract
+import com.memtrip.evm.eos.state.GetAccount
+import com.memtrip.evm.ethereum.EthAsset
+import okhttp3.OkHttpClient
+import okhttp3.logging.HttpLoggingInterceptor
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Test
+import org.web3j.abi.datatypes.Uint
+import java.math.BigInteger
+import java.util.concurrent.TimeUnit
+
+class RawBatchTest {
+
+    private val okHttpClient = OkHttpClient.Builder()
+        .addInterceptor(HttpLoggingInterceptor().setLevel(HttpLoggingInterceptor.Level.BODY))
+        .connectTimeout(10, TimeUnit.SECONDS)
+        .readTimeout(10, TimeUnit.SECONDS)
+        .writeTimeout(10, TimeUnit.SECONDS)
+        .build()
+
+    private val chainApi = Api(Config.CHAIN_API_BASE_URL, okHttpClient).chain
+
+    private val setupTransactions = SetupTransactions(chainApi)
+
+    private val rawBatchAction = RawBatchAction(chainApi)
+
+    private val getAccount = GetAccount(chainApi)
+
+    private val getCode = GetCode(chainApi)
+
+    @Test
+    fun `Funding a contract destroyed earlier in the batch fails and keeps the funds`() {
+        // given
+        val (newAccountName, newAccountPrivateKey, newEthAccount) = setupTransactions.seedWithEvmBalance()
+        val contract = RevertStorageContract(newAccountName, newAccountPrivateKey, newEthAccount)
+        val createContract = contract.createContract().blockingGet()
+        assertEquals(202, createContract.statusCode)
+
+        // when
+        val response = rawBatchAction.pushTransaction(
+            newAccountName,
+            listOf(
+                contract.signMethod(
+                    "dangerous",
+                    listOf(),
+                    listOf(),
+                    EvmSender(2, newEthAccount, newAccountName, newAccountPrivateKey, "")
+                ),
+                contract.signMethod(
+                    "setVars",
+                    listOf(Uint(BigInteger.ONE)),
+                    listOf(),
+                    EvmSender(3, newEthAccount, newAccountName, newAccountPrivateKey, "", EthAsset.milliether(100))
+                )
+            ),
+            TransactionContext(newAccountName, newAccountPrivateKey, transactionDefaultExpiry())
+        ).blockingGet()
+
+        // then
+        assertEquals(202, response.statusCode)
+        response.assertConsoleString("[0] MESSAGE_CALL_SUCCESS")
+        response.assertConsoleString("[1] MESSAGE_CALL_FAILED [An invalid address is attempting to modify a contract.]")
+
+        // and when
+        val balanceAfterBatch = getAccount.getEvmAccount(newAccountName).blockingGet()
+
+        // and then
+        if (balanceAfterBatch !is GetAccount.Record.Single) fail("Failed to check balance after the batch") else {
+            assertEquals("1.0000 EVM", balanceAfterBatch.item.balance.toString())
+        }
+
+        // and when
+        val parentCodeAfterBatch = getCode.getByAddress(createContract.parentContractAddress32).blockingGet()
+
+        // and then
+        assertTrue(parentCodeAfterBatch is GetCode.Record.None)
+    }
+
+    @Test
+    fun `A failing transaction is reported and the rest of the batch still runs`() {
+        // given
+        val (newAccountName, newAccountPrivateKey, newEthAccount) = setupTransactions.seedWithEvmBalance()
+        val contract = RevertStorageContract(newAccountName, newAccountPrivateKey, newEthAccount)
+        val createContract = contract.createContract().blockingGet()
+        assertEquals(202, createContract.statusCode)
+
+        // when
+        val response = rawBatchAction.pushTransaction(
+            newAccountName,
+            listOf(
+                contract.signMethod(
+                    "setVars",
+                    listOf(Uint(BigInteger.ONE)),
+                    listOf(),
+                    EvmSender(2, newEthAccount, newAccountName, newAccountPrivateKey, "")
+                ),
+                contract.signMethod(
+                    "missing",
+                    listOf(),
+                    listOf(),
+                    EvmSender(3, newEthAccount, newAccountName, newAccountPrivateKey, "")
+                ),
+                contract.signMethod(
+                    "setVars",
+                    listOf(Uint(BigInteger.TEN)),
+                    listOf(),
+                    EvmSender(4, newEthAccount, newAccountName, newAccountPrivateKey, "")
+                )
+            ),
+            TransactionContext(newAccountName, newAccountPrivateKey, transactionDefaultExpiry())
+        ).blockingGet()
+
+        // then
+        assertEquals(202, response.statusCode)
+        response.assertConsoleString("[0] MESSAGE_CALL_SUCCESS")
+        response.assertConsoleString("[1] MESSAGE_CALL_REVERTED")
+        response.assertConsoleString("[2] MESSAGE_CALL_SUCCESS")
+
+        // and when
+        val accountAfterBatch = getAccount.getEvmAccount(newAccountName).blockingGet()
+
+        // and then
+        if (accountAfterBatch !is GetAccount.Record.Single) fail("Failed to check the nonce after the batch") else {
+            assertEquals("4.0", accountAfterBatch.item.nonce)
+        }
+    }
+
+    @Test
+    fun `A contract destroyed twice in one batch is only removed once`() {
+        // given
+        val (newAccountName, newAccountPrivateKey, newEthAccount) = setupTransactions.seedWithEvmBalance()
+        val contract = RevertStorageContract(newAccountName, newAccountPrivateKey, newEthAccount)
+        val createContract = contract.createContract().blockingGet()
+        assertEquals(202, createContract.statusCode)
+
+        // when
+        val response = rawBatchAction.pushTransaction(
+            newAccountName,
+            listOf(
+                contract.signMethod(
+                    "dangerous",
+                    listOf(),
+                    listOf(),
+                    EvmSender(2, newEthAccount, newAccountName, newAccountPrivateKey, "")
+                ),
+                contract.signMethod(
+                    "dangerous",
+                    listOf(),
+                    listOf(),
+                    EvmSender(3, newEthAccount, newAccountName, newAccountPrivateKey, "")
+                )
+            ),
+            TransactionContext(newAccountName, newAccountPrivateKey, transactionDefaultExpiry())
+        ).blockingGet()
+
+        // then
+        assertEquals(202, response.statusCode)
+
+        // and when
+        val parentCodeAfterBatch = getCode.getByAddress(createContract.parentContractAddress32).blockingGet()
+
+        // and then
+        assertTrue(parentCodeAfterBatch is GetCode.Record.None)
+    }
+}
\ No newline at end of file
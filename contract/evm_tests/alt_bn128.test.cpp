@@ -0,0 +1,141 @@
+#include "catch.hpp"
+#include <evm/alt_bn128.hpp>
+#include <evm/hex.hpp>
+#include <evm/hash.hpp>
+#include "test_utils.hpp"
+
+static const std::string G1 = "0000000000000000000000000000000000000000000000000000000000000001"
+  "0000000000000000000000000000000000000000000000000000000000000002";
+static const std::string NEGATED_G1 = "0000000000000000000000000000000000000000000000000000000000000001"
+  "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd45";
+static const std::string G2 = "198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c2"
+  "1800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed"
+  "090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b"
+  "12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa";
+static const std::string G2_TIMES_3 = "1014772f57bb9742735191cd5dcfe4ebbc04156b6878a0a7c9824f32ffb66e85"
+  "06064e784db10e9051e52826e192715e8d7e478cb09a5e0012defa0694fbc7f5"
+  "021e2335f3354bb7922ffcc2f38d3323dd9453ac49b55441452aeaca147711b2"
+  "058e1d5681b5b9e0074b0f9c8d2c68a069b920d74521e79765036d57666c5597";
+static const std::string INFINITY_G1 = std::string(128, '0');
+
+static std::string run(bool (*operation)(const bytes_t&, bytes_t&), const std::string& input) {
+  bytes_t output;
+  REQUIRE(operation(Hex::hexToBytes(input), output));
+  return TestUtils::bytesToHex(output);
+}
+
+static bool rejects(bool (*operation)(const bytes_t&, bytes_t&), const std::string& input) {
+  bytes_t output;
+  return !operation(Hex::hexToBytes(input), output);
+}
+
+static std::string scalar(uint64_t value) {
+  return TestUtils::bytesToHex(BigInt::toBytes(value));
+}
+
+TEST_CASE("Field arithmetic matches mulmod", "[alt_bn128]") {
+  const uint256_t& p = Bn128Field::MODULUS;
+  uint256_t seed = 0x1f2e3d4c;
+  for (size_t i = 0; i < 16; i++) {
+    uint256_t a = Hash::keccak256Word(BigInt::toBytes(seed)) % p;
+    uint256_t b = Hash::keccak256Word(BigInt::toBytes(a)) % p;
+    seed = b;
+    CHECK(a == Bn128Field(a).word());
+    CHECK(intx::mulmod(a, b, p) == (Bn128Field(a) * Bn128Field(b)).word());
+    CHECK(intx::addmod(a, b, p) == (Bn128Field(a) + Bn128Field(b)).word());
+    CHECK(intx::addmod(a, p - b, p) == (Bn128Field(a) - Bn128Field(b)).word());
+    if (a != 0) CHECK(uint256_t(1) == (Bn128Field(a) * Bn128Field(a).inverse()).word());
+  }
+}
+
+TEST_CASE("Extension field inverses and the Frobenius map", "[alt_bn128]") {
+  Bn128Field12 f(
+    Bn128Field6(Bn128Field2(Bn128Field(12345), Bn128Field(777)), Bn128Field2(Bn128Field(3), Bn128Field(0)), Bn128Field2()),
+    Bn128Field6(Bn128Field2(), Bn128Field2(Bn128Field(8), Bn128Field(1)), Bn128Field2(Bn128Field(99), Bn128Field(5)))
+  );
+  CHECK(Bn128Field12::one() == f * f.inverse());
+  CHECK(f * f == f.square());
+
+  Bn128Field12 g = f;
+  for (size_t i = 0; i < 12; i++) g = g.frobenius();
+  CHECK(f == g);
+}
+
+TEST_CASE("The final exponentiation matches a plain exponentiation", "[alt_bn128]") {
+  Bn128Field12 f(
+    Bn128Field6(Bn128Field2(Bn128Field(12345), Bn128Field(777)), Bn128Field2(Bn128Field(3), Bn128Field(0)), Bn128Field2()),
+    Bn128Field6(Bn128Field2(), Bn128Field2(), Bn128Field2(Bn128Field(99), Bn128Field(5)))
+  );
+
+  // (p^4 - p^2 + 1) / r after the easy part (p^6 - 1)(p^2 + 1)
+  bytes_t hard = Hex::hexToBytes(
+    "01baaa710b0759ad331ec15183177faf6c0eb522d5b122784e529a5861876f6b3b1b1355d189227d79581e16f3fd90c66b887d56d5095f23aaa441e3954bcf8adcc7b44c87cdbacff1154e7e1da014fd5abf5cc4f49c36d4e81bb482ccdf42b1"
+  );
+  Bn128Field12 easy = f.conjugate() * f.inverse();
+  easy = easy.frobenius().frobenius() * easy;
+  Bn128Field12 expected = Bn128Field12::one();
+  for (uint8_t byte : hard) {
+    for (size_t bit = 8; bit > 0; bit--) {
+      expected = expected.square();
+      if (((byte >> (bit - 1)) & 1) != 0) expected = expected * easy;
+    }
+  }
+
+  CHECK(expected == AltBn128::finalExponentiation(f));
+}
+
+TEST_CASE("G1 addition", "[alt_bn128]") {
+  std::string g7 = "17072b2ed3bb8d759a5325f477629386cb6fc6ecb801bd76983a6b86abffe078168ada6cd130dd52017bb54bfa19377aadfe3bf05d18f41b77809f7f60d4af9e";
+  std::string g11 = "2a14705537b009189da8808651eecdb82482477fe92ac12ca8b71f80fc3d49ef2df7ee7f243ea8b38e1ddf14029258877a618c779fd4717db6177e19ea67ec38";
+  CHECK("2dbc7ba68f840c758c76373cd37b2cd78d6b02bee047cf401e8db90d73ce56f7062800987ee0dae9f9f36e1f050eb2621cbb4aa7c50b1c168ecc319370889de2" == run(AltBn128::add, g7 + g11));
+  CHECK("030644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd315ed738c0e0a7c92e7845f96b2ae9c0a68a6a449e3538fc7ff3ebf7a5a18a2c4" == run(AltBn128::add, G1 + G1));
+  CHECK(INFINITY_G1 == run(AltBn128::add, G1 + NEGATED_G1));
+  CHECK(G1 == run(AltBn128::add, G1 + INFINITY_G1));
+  // missing input is zero, the point at infinity
+  CHECK(G1 == run(AltBn128::add, G1));
+  CHECK(INFINITY_G1 == run(AltBn128::add, ""));
+}
+
+TEST_CASE("G1 addition rejects invalid points", "[alt_bn128]") {
+  // (1, 3) is not on the curve
+  CHECK(rejects(AltBn128::add, G1.substr(0, 64) + scalar(3) + G1));
+  // y + p is out of range even though it reduces to a point on the curve
+  CHECK(rejects(AltBn128::add, G1.substr(0, 64) + "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd49" + G1));
+}
+
+TEST_CASE("G1 scalar multiplication", "[alt_bn128]") {
+  CHECK("025e6c73f6db02c4b73f9a91fb2b1e1f5c12e14f4ed736038b82ed8cc8bbe47722b4610be887f1ee50592cf00c123aed6606a85ce0c132515831e13ed47f3a11" ==
+    run(AltBn128::multiply, G1 + "d76d4330f1446beab0c11fdecb91ce375bc8fbbcbde5c0994164d8399f767c45")
+  );
+  CHECK(INFINITY_G1 == run(AltBn128::multiply, G1 + TestUtils::bytesToHex(BigInt::toBytes(AltBn128::ORDER))));
+  CHECK(INFINITY_G1 == run(AltBn128::multiply, G1 + scalar(0)));
+  CHECK(INFINITY_G1 == run(AltBn128::multiply, INFINITY_G1 + scalar(5)));
+  CHECK(rejects(AltBn128::multiply, G1.substr(0, 64) + scalar(3) + scalar(2)));
+}
+
+TEST_CASE("Pairing checks", "[alt_bn128]") {
+  std::string one = scalar(1);
+  std::string zero = scalar(0);
+
+  CHECK(one == run(AltBn128::pairing, ""));
+  CHECK(one == run(AltBn128::pairing, G1 + G2 + NEGATED_G1 + G2));
+  CHECK(zero == run(AltBn128::pairing, G1 + G2));
+  CHECK(one == run(AltBn128::pairing, INFINITY_G1 + G2));
+
+  // e(2 G1, 3 G2) e(-6 G1, G2) = 1
+  std::string g1Times2 = run(AltBn128::multiply, G1 + scalar(2));
+  std::string negatedG1Times6 = run(AltBn128::multiply, NEGATED_G1 + scalar(6));
+  CHECK(one == run(AltBn128::pairing, g1Times2 + G2_TIMES_3 + negatedG1Times6 + G2));
+  CHECK(zero == run(AltBn128::pairing, g1Times2 + G2 + negatedG1Times6 + G2));
+}
+
+TEST_CASE("Pairing checks reject invalid input", "[alt_bn128]") {
+  CHECK(rejects(AltBn128::pairing, G1 + G2.substr(0, 254)));
+  // swapping the real and imaginary parts of x moves the point off the twist
+  CHECK(rejects(AltBn128::pairing, G1 + G2.substr(64, 64) + G2.substr(0, 64) + G2.substr(128)));
+  // on the twist but outside the order r subgroup
+  CHECK(rejects(AltBn128::pairing, G1 +
+    "280bf6a8ad864c44e049548e8a0a8c9632ea6928f6236bf2504b74ba4a0fe75d0aa7ae83df561d802a759159fb7ff337f5cae3bf3729c619c60a3cab359eeefb"
+    "0220570d0e2a6bc010d1c8a3681d067e774e78ec36c1f99b59c78dee462bf87527612e8cf180450a0a8ccff8a25f9f6b6a54be4e7e0d4874aa1092230d7420b2"
+  ));
+}
@@ -0,0 +1,74 @@
+#include "catch.hpp"
+#include <memory>
+#include <evm/code_analysis.hpp>
+#include <evm/types.h>
+#include <evm/hex.hpp>
+
+TEST_CASE("Code analysis marks jump destinations", "[code_analysis]") {
+  // given
+  bytes_t bytes = Hex::hexToBytes("60055b005b");
+
+  // when
+  CodeAnalysis analysis(std::make_shared<bytes_t>(bytes));
+
+  // then
+  REQUIRE(5 == analysis.codeSize);
+  REQUIRE(analysis.isJumpDestination(2));
+  REQUIRE(analysis.isJumpDestination(4));
+  REQUIRE_FALSE(analysis.isJumpDestination(1));
+  REQUIRE_FALSE(analysis.isJumpDestination(3));
+  REQUIRE_FALSE(analysis.isJumpDestination(64));
+  REQUIRE_FALSE(analysis.isJumpDestination(0xFFFFFFFF));
+}
+
+TEST_CASE("Code analysis is cached by code hash", "[code_analysis]") {
+  // given
+  CodeAnalysisCache cache;
+  std::shared_ptr<bytes_t> code = std::make_shared<bytes_t>(Hex::hexToBytes("5b600056"));
+  std::shared_ptr<bytes_t> other = std::make_shared<bytes_t>(Hex::hexToBytes("60035b"));
+
+  // when
+  std::shared_ptr<CodeAnalysis> first = cache.get(0x01, code);
+  std::shared_ptr<CodeAnalysis> second = cache.get(0x01, code);
+  std::shared_ptr<CodeAnalysis> third = cache.get(0x02, other);
+
+  // then
+  REQUIRE(first == second);
+  REQUIRE(first != third);
+  REQUIRE(1 == cache.hits);
+  REQUIRE(2 == cache.misses);
+  REQUIRE(2 == cache.size());
+  REQUIRE(third->isJumpDestination(2));
+}
+
+TEST_CASE("Code analysis splits basic blocks", "[code_analysis]") {
+  // given
+  // JUMPDEST PUSH1 1 JUMPDEST ADD PUSH1 0 SSTORE PUSH1 0 JUMP PC
+  bytes_t bytes = Hex::hexToBytes("5b60015b01600055600056" "58");
+
+  // when
+  CodeAnalysis analysis(std::make_shared<bytes_t>(bytes));
+
+  // then
+  REQUIRE(4 == analysis.blocks.size());
+  REQUIRE(0 == analysis.blocks[0].start);
+  REQUIRE(3 == analysis.blocks[0].end);
+  REQUIRE(4 == analysis.blocks[0].gas);
+  REQUIRE(0 == analysis.blocks[0].stackMin);
+  REQUIRE(1 == analysis.blocks[0].stackMax);
+
+  REQUIRE(3 == analysis.blocks[1].start);
+  REQUIRE(7 == analysis.blocks[1].end);
+  REQUIRE(7 == analysis.blocks[1].gas);
+  REQUIRE(-2 == analysis.blocks[1].stackMin);
+  REQUIRE(0 == analysis.blocks[1].stackMax);
+
+  REQUIRE(8 == analysis.blocks[2].start);
+  REQUIRE(11 == analysis.blocks[2].end);
+  REQUIRE(11 == analysis.blocks[2].gas);
+
+  REQUIRE(11 == analysis.blocks[3].start);
+  REQUIRE(2 == analysis.findBlock(8));
+  REQUIRE(2 == analysis.findBlock(7));
+  REQUIRE(4 == analysis.findBlock(12));
+}
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+#include <memory>
+#include <evm/execute.hpp>
+#include <evm/utils.hpp>
+#include <evm/hex.hpp>
+#include "external_mock.hpp"
+
+TEST_CASE("Execute a value transfer to an address without code", "[execute]") {
+
+  // given
+  std::shared_ptr<ExternalMock> external = std::make_shared<ExternalMock>();
+  std::shared_ptr<PendingState> pendingState = std::make_shared<PendingState>();
+  uint256_t toAddress = uint256_t(0xea0e9b);
+
+  // when
+  call_result_t result = Execute::transaction(
+    uint256_t(0xaa0e9a), 1, Utils::env(), TransactionActionType::TRANSACTION_CALL,
+    30000, uint256_t(1), uint256_t(10), std::make_shared<bytes_t>(), toAddress,
+    std::make_shared<Memory>(), std::shared_ptr<Operation>(), std::shared_ptr<GasCalculation>(),
+    external, pendingState
+  );
+
+  // then
+  CHECK(MessageCallResult::MESSAGE_CALL_SUCCESS == result.first);
+  CHECK(30000 == std::get<gas_t>(result.second));
+  REQUIRE(1 == external->transferSpy.size());
+  CHECK(toAddress == external->transferSpy[0]);
+}
+
+TEST_CASE("Execute a zero value transfer to an address without code", "[execute]") {
+
+  // given
+  std::shared_ptr<ExternalMock> external = std::make_shared<ExternalMock>();
+  std::shared_ptr<PendingState> pendingState = std::make_shared<PendingState>();
+
+  // when
+  call_result_t result = Execute::transfer(uint256_t(0xaa0e9a), uint256_t(0xea0e9b), uint256_t(0), 21000, external, pendingState);
+
+  // then
+  CHECK(MessageCallResult::MESSAGE_CALL_SUCCESS == result.first);
+  CHECK(21000 == std::get<gas_t>(result.second));
+  CHECK(0 == external->transferSpy.size());
+}
+
+TEST_CASE("Execute a call to an address with code", "[execute]") {
+
+  // given
+  std::shared_ptr<ExternalMock> external = std::make_shared<ExternalMock>();
+  std::shared_ptr<PendingState> pendingState = std::make_shared<PendingState>();
+  uint256_t toAddress = uint256_t(0xea0e9b);
+  // PUSH1 1 PUSH1 0 SSTORE STOP
+  external->codeResponder.push_back(std::make_pair(toAddress, Hex::hexToBytes("600160005500")));
+
+  // when
+  call_result_t result = Execute::transaction(
+    uint256_t(0xaa0e9a), 1, Utils::env(), TransactionActionType::TRANSACTION_CALL,
+    30000, uint256_t(1), uint256_t(0), std::make_shared<bytes_t>(), toAddress,
+    std::make_shared<Memory>(), std::make_shared<Operation>(), std::make_shared<GasCalculation>(),
+    external, pendingState
+  );
+
+  // then
+  CHECK(MessageCallResult::MESSAGE_CALL_SUCCESS == result.first);
+  CHECK(30000 - 20006 == std::get<gas_t>(result.second));
+  CHECK(uint256_t(1) == pendingState->getState(uint256_t(0), toAddress));
+}
+
+// answers codeHash from a stored value, the way eos_external reads it from the account row
+class StoredCodeHashExternal: public ExternalMock {
+  public:
+    uint256_t storedCodeHash;
+
+    uint256_t codeHash(const uint256_t& address, std::shared_ptr<PendingState> pendingState) {
+      return storedCodeHash;
+    }
+};
+
+TEST_CASE("Calls key the code analysis by the stored code hash", "[execute]") {
+
+  // given
+  std::shared_ptr<StoredCodeHashExternal> external = std::make_shared<StoredCodeHashExternal>();
+  external->storedCodeHash = uint256_t(0xc0de);
+  std::shared_ptr<PendingState> pendingState = std::make_shared<PendingState>();
+  uint256_t toAddress = uint256_t(0xea0e9b);
+  std::shared_ptr<bytes_t> code = std::make_shared<bytes_t>(Hex::hexToBytes("600160005500"));
+  external->codeResponder.push_back(std::make_pair(toAddress, *code));
+
+  // when
+  Execute::transaction(
+    uint256_t(0xaa0e9a), 1, Utils::env(), TransactionActionType::TRANSACTION_CALL,
+    30000, uint256_t(1), uint256_t(0), std::make_shared<bytes_t>(), toAddress,
+    std::make_shared<Memory>(), std::make_shared<Operation>(), std::make_shared<GasCalculation>(),
+    external, pendingState
+  );
+
+  // then
+  CHECK(1 == pendingState->codeAnalysis.misses);
+  pendingState->codeAnalysis.get(uint256_t(0xc0de), code);
+  CHECK(1 == pendingState->codeAnalysis.hits);
+}
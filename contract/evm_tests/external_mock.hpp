@@ -19,6 +19,8 @@ class ExternalMock: public External {
     log_spy_t logSpy;
     word_spy_t codeSpy;
     word_spy_t selfdestructSpy;
+    word_spy_t transferSpy;
+    word_spy_t ecrecoverSpy;
     string_spy_t emplaceSpy;
     bytes_responder_t codeResponder;
     balance_responder_t balanceResponder;
@@ -28,6 +30,8 @@ class ExternalMock: public External {
       logSpy = log_spy_t();
       codeSpy = word_spy_t();
       selfdestructSpy = word_spy_t();
+      transferSpy = word_spy_t();
+      ecrecoverSpy = word_spy_t();
       emplaceSpy = string_spy_t();
       codeResponder = bytes_responder_t();
       balanceResponder = balance_responder_t();
@@ -82,9 +86,15 @@ class ExternalMock: public External {
       const uint256_t& value,
       std::shared_ptr<PendingState> pendingState
     ) { 
+      transferSpy.push_back(toAddressWord);
       return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
     };
 
+    bytes_t ecrecover(const uint256_t& hash, uint8_t recoveryId, const uint256_t& r, const uint256_t& s) {
+      ecrecoverSpy.push_back(hash);
+      return Secp256k1::recover(hash, recoveryId, r, s);
+    }
+
     uint256_t incrementContractNonce(const uint256_t& address) { return uint256_t(0); };
 
     emplace_t emplaceCodeAddress(
@@ -0,0 +1,57 @@
+#include "catch.hpp"
+#include <evm/frame_arena.hpp>
+#include <evm/types.h>
+
+TEST_CASE("Frame arena hands out one stack and memory per depth", "[frame_arena]") {
+  // given
+  FrameArena frames;
+
+  // when
+  StackMachine& first = frames.stack(1);
+  StackMachine& second = frames.stack(2);
+  Memory& memory = frames.memory(1);
+
+  // then
+  REQUIRE(&first != &second);
+  REQUIRE(&first == &frames.stack(1));
+  REQUIRE(&memory == &frames.memory(1));
+  REQUIRE(3 == frames.depth());
+}
+
+TEST_CASE("Frame arena recycles slots empty but keeps their capacity", "[frame_arena]") {
+  // given
+  FrameArena frames;
+  StackMachine& stack = frames.stack(1);
+  stack.push(UINT256_ONE);
+  stack.push(UINT256_ONE);
+  Memory& memory = frames.memory(1);
+  memory.expand(8 * 1024);
+  memory.writeByte(10, uint256_t(0xaa));
+  size_t capacity = memory.memory.capacity();
+
+  // when
+  StackMachine& nextStack = frames.stack(1);
+  Memory& nextMemory = frames.memory(1);
+
+  // then
+  REQUIRE(&stack == &nextStack);
+  REQUIRE(0 == nextStack.size());
+  REQUIRE(0 == nextMemory.length());
+  REQUIRE(capacity == nextMemory.memory.capacity());
+  nextMemory.expand(32);
+  REQUIRE(0 == nextMemory.memory[10]);
+}
+
+TEST_CASE("Frame arena slots stay put while deeper frames are added", "[frame_arena]") {
+  // given
+  FrameArena frames;
+  StackMachine& shallow = frames.stack(1);
+  shallow.push(UINT256_ONE);
+
+  // when
+  for (uint16_t depth = 2; depth < 64; depth++) frames.stack(depth);
+
+  // then
+  REQUIRE(1 == shallow.size());
+  REQUIRE(64 == frames.depth());
+}
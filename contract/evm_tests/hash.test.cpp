@@ -39,4 +39,40 @@ TEST_CASE("keccak256 wlrd", "[hash]" ) {
   REQUIRE("d4aeab6b14081f43dd4fdf6ac0dc3b289fdd8dff4adf98254993e524e77993ae" == 
     Utils::uint256_2str(hash)
   );
-}
\ No newline at end of file
+}
+TEST_CASE("EMPTY_CODE_HASH is the keccak256 of no bytes", "[hash]" ) {
+  REQUIRE(EMPTY_CODE_HASH == Hash::keccak256Word(bytes_t()));
+}
+
+TEST_CASE("keccak256WordPairs matches keccak256WordPair", "[hash]" ) {
+  std::vector<std::pair<uint256_t, uint256_t>> pairs;
+  for (size_t i = 0; i < 11; i++) {
+    pairs.push_back(std::make_pair(uint256_t(0xea0e9a) + i, (uint256_t(i) << 200) + 7 * i));
+  }
+
+  std::vector<uint256_t> hashes = Hash::keccak256WordPairs(pairs);
+  REQUIRE(pairs.size() == hashes.size());
+  for (size_t i = 0; i < pairs.size(); i++) {
+    CHECK(Hash::keccak256WordPair(pairs[i].first, pairs[i].second) == hashes[i]);
+  }
+  CHECK(Hash::keccak256WordPairs(std::vector<std::pair<uint256_t, uint256_t>>()).empty());
+}
+
+TEST_CASE("Batched keccak256 of inputs around the block size", "[hash]" ) {
+  // short and long inputs interleaved, including the sizes either side of one 136 byte block
+  std::vector<size_t> sizes { 0, 1, 135, 136, 137, 64, 300, 32, 85, 7, 272, 20, 135 };
+  std::vector<bytes_t> inputs;
+  std::vector<const uint8_t*> data;
+  for (size_t size : sizes) {
+    bytes_t input(size);
+    for (size_t i = 0; i < size; i++) input[i] = static_cast<uint8_t>(i * 31 + size);
+    inputs.push_back(input);
+  }
+  for (const bytes_t& input : inputs) data.push_back(input.data());
+
+  std::vector<ethash::hash256> results(sizes.size());
+  ethash::keccak256_batch(results.data(), data.data(), sizes.data(), sizes.size());
+  for (size_t i = 0; i < sizes.size(); i++) {
+    CHECK(Hash::keccak256(inputs[i]) == bytes_t(results[i].bytes, results[i].bytes + 32));
+  }
+}
@@ -7,11 +7,9 @@
 #include <evm/utils.hpp>
 
 std::vector<uint64_t> jump_destinations(std::string bytecode_str) {
-  std::vector<uint64_t> output;
   bytes_t bytes = Hex::hexToBytes(bytecode_str);
-  jump_set_t destinations = Jumps::findDestinations(std::make_shared<bytes_t>(bytes));
-  std::copy(destinations.begin(), destinations.end(), std::back_inserter(output));
-  return output;
+  jump_map_t destinations = Jumps::findDestinations(std::make_shared<bytes_t>(bytes));
+  return Jumps::destinations(destinations);
 }
 
 TEST_CASE("Find jump distinations", "[jumps]") {
@@ -43,12 +41,26 @@ TEST_CASE("Find jump distinations in COPYCODE contract", "[jumps]") {
   REQUIRE(248 == jumps[6]); 
 }
 
+TEST_CASE("Find jump distinations across skipped words", "[jumps]") {
+  // given
+  std::string bytecode_str = "0101010101010101010101010101015b01010101010101015b6a5b5b5b5b5b5b5b5b5b5b5b5b";
+
+  // when
+  std::vector<uint64_t> jumps = jump_destinations(bytecode_str);
+
+  // then
+  REQUIRE(3 == jumps.size()); 
+  REQUIRE(15 == jumps[0]); 
+  REQUIRE(24 == jumps[1]); 
+  REQUIRE(37 == jumps[2]); 
+}
+
 TEST_CASE("Verify jumps", "[jumps]") {
   // given
-  jump_set_t jumps = jump_set_t();
-  jumps.insert(2);
-  jumps.insert(5);
-  jumps.insert(10);
+  jump_map_t jumps = jump_map_t(1, 0);
+  jumps[0] |= uint64_t(1) << 2;
+  jumps[0] |= uint64_t(1) << 5;
+  jumps[0] |= uint64_t(1) << 10;
 
   // then
   REQUIRE(5 == Jumps::verifyJump(5, jumps)); 
@@ -0,0 +1,36 @@
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include <vector>
+#include <evm/keccak_stream.hpp>
+#include <evm/hash.hpp>
+#include <evm/hex.hpp>
+
+static bytes_t streamed(const bytes_t& bytes, size_t chunk) {
+  KeccakStream stream;
+  for (size_t offset = 0; offset < bytes.size(); offset += chunk) {
+    stream.update(bytes.data() + offset, std::min(chunk, bytes.size() - offset));
+  }
+  ethash::hash256 hash = stream.finalize();
+  return bytes_t(&hash.bytes[0], &hash.bytes[32]);
+}
+
+TEST_CASE("Keccak stream of empty input", "[keccak_stream]") {
+  KeccakStream stream;
+  ethash::hash256 hash = stream.finalize();
+  CHECK("c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470" == 
+    TestUtils::bytesToHex(bytes_t(&hash.bytes[0], &hash.bytes[32]))
+  );
+}
+
+TEST_CASE("Keccak stream matches one-shot keccak across block boundaries", "[keccak_stream]") {
+  for (size_t size : { 1, 135, 136, 137, 271, 272, 1000 }) {
+    bytes_t bytes(size);
+    for (size_t i = 0; i < size; i++) bytes[i] = static_cast<uint8_t>(i * 7 + 3);
+    bytes_t expected = Hash::keccak256(bytes);
+
+    for (size_t chunk : { 1, 5, 64, 136, 200, 2000 }) {
+      CHECK(expected == streamed(bytes, chunk));
+    }
+  }
+}
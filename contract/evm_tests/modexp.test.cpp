@@ -0,0 +1,41 @@
+#include "catch.hpp"
+#include <evm/modexp.hpp>
+#include <evm/hex.hpp>
+#include "test_utils.hpp"
+
+static std::string power(const std::string& base, const std::string& exponent, const std::string& modulus) {
+  return TestUtils::bytesToHex(ModExp::power(Hex::hexToBytes(base), Hex::hexToBytes(exponent), Hex::hexToBytes(modulus)));
+}
+
+TEST_CASE("Small powers", "[modexp]") {
+  CHECK("2b" == power("03", "05", "64"));
+  CHECK("0005" == power("03", "05", "0007"));
+  CHECK("01" == power("03", "", "07"));
+  CHECK("00" == power("03", "05", "01"));
+  CHECK("0000" == power("03", "05", "0000"));
+  CHECK("00" == power("", "05", "07"));
+}
+
+TEST_CASE("Fermat's little theorem for the secp256k1 prime", "[modexp]") {
+  CHECK("0000000000000000000000000000000000000000000000000000000000000001" == power(
+    "03",
+    "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2e",
+    "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f"
+  ));
+}
+
+TEST_CASE("Odd 1024 bit modulus with a wider base", "[modexp]") {
+  CHECK("04bdf44278390d17b2c5b9a3089b40ccf64cb2a387d74c08d3f4113ac14d48454d8d9f848d9f74824c2169cc440d9201d514999ab675de4e594ee1b785fa1236646f2774063e9fb4776d446c3c082dd0a9a8abfdf67499ca1ee0cadca6bdb1e60cc93b84d60d95b4b43e0c681bebfb98d7a4fc5c136e27c17eecf1a4a90153ce" == power(
+    "0101b64ce4228c38fb2918f135d25f557203301850c5a38fd547923a736994e3bf911a61dbe22e44158bae97ba94d0eda82f8f6d05584ef8aa38922766581e27a1c08a6a63ec24ede6a46b4cb2424a23d5962217beaddbc496cb8e81973e0becd7b03898d190f9ebdacc0cb1e29c658cda1495e60af593bd04cf0fd630f1f29d0da9953f48f1a09f76b5",
+    "03e7d1bfc7a2ea20b2f14c942e05319acb5c74273f98e2774cbd87ad5c90a9587403e430ec66a78795e761d17731af10506bf2efc6f877186d76b07e881ed162ae2eb1547f15052434b9b5df9e7769b10f4205b4907a70c3",
+    "a170b33839263059f28c105d1fb17c2390c192cfd3ac94af0f21ddb66cad4a268d116ece1738f7d93d9c172411e20b8f6b0d549b6f03675a1600a35a099950d836f675cc81e74ef5e8e25d940ed904759531985d5d9dc9f81818e811892f902bd23f0824128b2f330c5c7fd0a6a3a4506513270e269e0d37f2a74de452e6b439"
+  ));
+}
+
+TEST_CASE("Even modulus", "[modexp]") {
+  CHECK("096764d7e5e509d239659de09f073e3b580b0ac78c1e64231a6fa3e2b7d46648af0780294c40" == power(
+    "a179cb9e86830c71c2cdcc69292f45e678309d6b79965eda32",
+    "00bea450cb0088539d2c67ed",
+    "0db0403c57ae75690ecee69af838ffbd00bd932211bb6b6bf571e9a7c4fbb429298e79e4ada0"
+  ));
+}
@@ -28,9 +28,11 @@ TEST_CASE("Get an item for a given key, when there are multiple items for the sa
   pendingState.currentStackDepth = 1;
   pendingState.putState(uint256_t(0x00), uint256_t(0xF1), uint256_t(0xA1));
   pendingState.putState(uint256_t(0x00), uint256_t(0xF2), uint256_t(0xA1));
+  checkpoint_t depth2 = pendingState.checkpoint();
   pendingState.currentStackDepth = 2;
   pendingState.putState(uint256_t(0x00), uint256_t(0xF3), uint256_t(0xA1));
   pendingState.putState(uint256_t(0x00), uint256_t(0xF4), uint256_t(0xA1));
+  checkpoint_t depth3 = pendingState.checkpoint();
   pendingState.currentStackDepth = 3;
   pendingState.putState(uint256_t(0x00), uint256_t(0xF5), uint256_t(0xA1));
 
@@ -38,13 +40,13 @@ TEST_CASE("Get an item for a given key, when there are multiple items for the sa
   CHECK(uint256_t(0xF5) == pendingState.getState(uint256_t(0x00), uint256_t(0xA1)));
 
   // and when
-  pendingState.revert(3);
+  pendingState.revert(depth3);
 
   // and then
   CHECK(uint256_t(0xF4) == pendingState.getState(uint256_t(0x00), uint256_t(0xA1)));
 
   // and when
-  pendingState.revert(2);
+  pendingState.revert(depth2);
 
   // and then
   CHECK(uint256_t(0xF2) == pendingState.getState(uint256_t(0x00), uint256_t(0xA1)));
@@ -84,11 +86,12 @@ TEST_CASE("Revert account state at the deepest depth", "[pending_state]") {
   pendingState.currentStackDepth = 2;
   pendingState.putState(uint256_t(0x03), uint256_t(0xF3), uint256_t(0xA3));
   pendingState.putState(uint256_t(0x04), uint256_t(0xF4), uint256_t(0xA4));
+  checkpoint_t depth3 = pendingState.checkpoint();
   pendingState.currentStackDepth = 3;
   pendingState.putState(uint256_t(0x05), uint256_t(0xF5), uint256_t(0xA5));
 
   // when
-  pendingState.revert(3);
+  pendingState.revert(depth3);
 
   // then
   CHECK(uint256_t(0xA1) == pendingState.accountState[0].codeAddress);
@@ -111,6 +114,7 @@ TEST_CASE("Revert account state at a middle depth", "[pending_state]") {
   pendingState.currentStackDepth = 1;
   pendingState.putState(uint256_t(0x00), uint256_t(0xF1), uint256_t(0xA1));
   pendingState.putState(uint256_t(0x02), uint256_t(0xF2), uint256_t(0xA2));
+  checkpoint_t depth2 = pendingState.checkpoint();
   pendingState.currentStackDepth = 2;
   pendingState.putState(uint256_t(0x03), uint256_t(0xF3), uint256_t(0xA3));
   pendingState.putState(uint256_t(0x04), uint256_t(0xF4), uint256_t(0xA4));
@@ -118,7 +122,7 @@ TEST_CASE("Revert account state at a middle depth", "[pending_state]") {
   pendingState.putState(uint256_t(0x05), uint256_t(0xF5), uint256_t(0xA5));
 
   // when
-  pendingState.revert(2);
+  pendingState.revert(depth2);
 
   // then
   CHECK(uint256_t(0xA1) == pendingState.accountState[0].codeAddress);
@@ -134,6 +138,7 @@ TEST_CASE("Revert account state at the top", "[pending_state]") {
   // given
   PendingState pendingState {};
 
+  checkpoint_t depth1 = pendingState.checkpoint();
   pendingState.currentStackDepth = 1;
   pendingState.putState(uint256_t(0x00), uint256_t(0xF1), uint256_t(0xA1));
   pendingState.putState(uint256_t(0x02), uint256_t(0xF2), uint256_t(0xA2));
@@ -144,7 +149,7 @@ TEST_CASE("Revert account state at the top", "[pending_state]") {
   pendingState.putState(uint256_t(0x05), uint256_t(0xF5), uint256_t(0xA5));
 
   // when
-  pendingState.revert(1);
+  pendingState.revert(depth1);
 
   // then
   CHECK(0 == pendingState.accountState.size());
@@ -161,11 +166,12 @@ TEST_CASE("Revert logs at the deepest depth", "[pending_state]") {
   pendingState.currentStackDepth = 2;
   pendingState.log(std::vector<uint256_t>(), bytes_t { 2, 0 });
   pendingState.log(std::vector<uint256_t>(), bytes_t { 2, 1 });
+  checkpoint_t depth3 = pendingState.checkpoint();
   pendingState.currentStackDepth = 3;
   pendingState.log(std::vector<uint256_t>(), bytes_t { 3, 0 });
 
   // when
-  pendingState.revert(3);
+  pendingState.revert(depth3);
 
   // then
   CHECK(Hex::bytesToHex(bytes_t { 1, 0 }) == Hex::bytesToHex(pendingState.logs[0].data));
@@ -188,6 +194,7 @@ TEST_CASE("Revert logs at a middle depth", "[pending_state]") {
   pendingState.currentStackDepth = 1;
   pendingState.log(std::vector<uint256_t>(), bytes_t { 1, 0 });
   pendingState.log(std::vector<uint256_t>(), bytes_t { 1, 1 });
+  checkpoint_t depth2 = pendingState.checkpoint();
   pendingState.currentStackDepth = 2;
   pendingState.log(std::vector<uint256_t>(), bytes_t { 2, 0 });
   pendingState.log(std::vector<uint256_t>(), bytes_t { 2, 1 });
@@ -195,7 +202,7 @@ TEST_CASE("Revert logs at a middle depth", "[pending_state]") {
   pendingState.log(std::vector<uint256_t>(), bytes_t { 3, 0 });
 
   // when
-  pendingState.revert(2);
+  pendingState.revert(depth2);
 
   // then
   CHECK(Hex::bytesToHex(bytes_t { 1, 0 }) == Hex::bytesToHex(pendingState.logs[0].data));
@@ -208,6 +215,7 @@ TEST_CASE("Revert logs at the top", "[pending_state]") {
   // given
   PendingState pendingState {};
 
+  checkpoint_t depth1 = pendingState.checkpoint();
   pendingState.currentStackDepth = 1;
   pendingState.log(std::vector<uint256_t>(), bytes_t { 1, 0 });
   pendingState.log(std::vector<uint256_t>(), bytes_t { 1, 1 });
@@ -218,7 +226,7 @@ TEST_CASE("Revert logs at the top", "[pending_state]") {
   pendingState.log(std::vector<uint256_t>(), bytes_t { 3, 0 });
 
   // when
-  pendingState.revert(1);
+  pendingState.revert(depth1);
 
   // then
   CHECK(0 == pendingState.logs.size());
@@ -347,13 +355,14 @@ TEST_CASE("Balances changes from a reverted stack depth are not included in the
   pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_ADD, BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, uint256_t(0xA), uint256_t(0x20));
   pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_ADD, BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, uint256_t(0xA), uint256_t(0x30));
   pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_ADD, BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, uint256_t(0xA), uint256_t(0x12));
+  checkpoint_t depth2 = pendingState.checkpoint();
   pendingState.currentStackDepth = 2;
   pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_SUBTRACT, BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, uint256_t(0xA), uint256_t(0x72));
 
   // when
   uint256_t balanceBeforeRevert = pendingState.balanceWithPendingChanges(uint256_t(0xA), uint256_t(0x00));
 
-  pendingState.revert(2);
+  pendingState.revert(depth2);
 
   uint256_t balanceAfterRevert = pendingState.balanceWithPendingChanges(uint256_t(0xA), uint256_t(0x00));
 
@@ -379,10 +388,14 @@ TEST_CASE("Balance changes are resolved for each address", "[pending_state]") {
   pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_ADD, BalanceAddressType::BALANCE_ADDRESS_CONTRACT, uint256_t(0xA), uint256_t(0x72));
 
   // when
-  std::set<resolved_balance_t> addresses = pendingState.resolvedBalanceAddresses();
+  std::vector<resolved_balance_t> addresses = pendingState.resolvedBalanceAddresses();
 
   // then
-  CHECK(3 == addresses.size());
+  REQUIRE(3 == addresses.size());
+  CHECK(uint256_t(0xA) == addresses[0].address);
+  CHECK(BalanceAddressType::BALANCE_ADDRESS_CONTRACT == addresses[0].addressType);
+  CHECK(uint256_t(0xC) == addresses[1].address);
+  CHECK(uint256_t(0xB) == addresses[2].address);
 }
 
 TEST_CASE("Ensure that balances can't overflow", "[pending_state]") {
@@ -428,9 +441,10 @@ TEST_CASE("A self destruct pending change is removed by a revert", "[pending_sta
   // when
   pendingState.currentStackDepth = 1;
   pendingState.putSelfDestruct(uint256_t(0xA));
+  checkpoint_t depth2 = pendingState.checkpoint();
   pendingState.currentStackDepth = 2;
   pendingState.putSelfDestruct(uint256_t(0xB));
-  pendingState.revert(2);
+  pendingState.revert(depth2);
 
   // then
   REQUIRE(1 == pendingState.selfDestruct.size());
@@ -462,9 +476,10 @@ TEST_CASE("Two contracts are created at different stack depths, stack depth 2 is
   // when
   pendingState.currentStackDepth = 1;
   pendingState.putContractCreate(uint256_t(0xA));
+  checkpoint_t depth2 = pendingState.checkpoint();
   pendingState.currentStackDepth = 2;
   pendingState.putContractCreate(uint256_t(0xB));
-  pendingState.revert(2);
+  pendingState.revert(depth2);
 
   // then
   REQUIRE(1 == pendingState.revertedContractCreation.size());
@@ -479,11 +494,12 @@ TEST_CASE("Two contracts are created at different stack depths, stack depth 1 is
   PendingState pendingState {};
 
   // when
+  checkpoint_t depth1 = pendingState.checkpoint();
   pendingState.currentStackDepth = 1;
   pendingState.putContractCreate(uint256_t(0xA));
   pendingState.currentStackDepth = 2;
   pendingState.putContractCreate(uint256_t(0xB));
-  pendingState.revert(1);
+  pendingState.revert(depth1);
 
   // then
   REQUIRE(2 == pendingState.revertedContractCreation.size());
@@ -493,4 +509,97 @@ TEST_CASE("Two contracts are created at different stack depths, stack depth 1 is
   CHECK(Utils::uint256_2str(pendingState.revertedContractCreation[1].address) == 
     "000000000000000000000000000000000000000000000000000000000000000b"
   );
-}
\ No newline at end of file
+}
+
+TEST_CASE("Reverting to a checkpoint restores the slot values from before it", "[pending_state]") {
+
+  // given
+  PendingState pendingState {};
+  pendingState.currentStackDepth = 1;
+  pendingState.putState(uint256_t(0x00), uint256_t(0xF1), uint256_t(0xA1));
+  checkpoint_t checkpoint = pendingState.checkpoint();
+
+  // when
+  pendingState.currentStackDepth = 2;
+  pendingState.putState(uint256_t(0x00), uint256_t(0xF2), uint256_t(0xA1));
+  pendingState.putState(uint256_t(0x01), uint256_t(0xF3), uint256_t(0xA1));
+  pendingState.log({ uint256_t(0x01) }, bytes_t { 2, 0 });
+  pendingState.putBalanceChange(BALANCE_CHANGE_ADD, BALANCE_ADDRESS_ACCOUNT, uint256_t(0xA1), uint256_t(10));
+  pendingState.putContractCreate(uint256_t(0xB));
+  pendingState.revert(checkpoint);
+
+  // then
+  CHECK(uint256_t(0xF1) == pendingState.getState(uint256_t(0x00), uint256_t(0xA1)));
+  CHECK(uint256_t(0x00) == pendingState.getState(uint256_t(0x01), uint256_t(0xA1)));
+  CHECK(1 == pendingState.accountState.size());
+  CHECK(0 == pendingState.logs.size());
+  CHECK(0 == pendingState.balanceChange.size());
+  REQUIRE(1 == pendingState.revertedContractCreation.size());
+  CHECK(uint256_t(0xB) == pendingState.revertedContractCreation[0].address);
+}
+
+TEST_CASE("Reverting to a checkpoint keeps changes from an earlier sibling frame", "[pending_state]") {
+
+  // given
+  PendingState pendingState {};
+  pendingState.currentStackDepth = 2;
+  pendingState.putState(uint256_t(0x00), uint256_t(0xF1), uint256_t(0xA1));
+
+  // when
+  checkpoint_t checkpoint = pendingState.checkpoint();
+  pendingState.putState(uint256_t(0x00), uint256_t(0xF2), uint256_t(0xA1));
+  pendingState.revert(checkpoint);
+
+  // then
+  CHECK(uint256_t(0xF1) == pendingState.getState(uint256_t(0x00), uint256_t(0xA1)));
+  CHECK(1 == pendingState.accountState.size());
+}
+
+TEST_CASE("Reverting to a checkpoint drops its balance changes and the addresses it first touched", "[pending_state]") {
+
+  // given
+  PendingState pendingState {};
+  pendingState.currentStackDepth = 1;
+  pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_ADD, BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, uint256_t(0xA), uint256_t(0x10));
+  checkpoint_t checkpoint = pendingState.checkpoint();
+
+  // when
+  pendingState.currentStackDepth = 2;
+  pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_SUBTRACT, BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, uint256_t(0xA), uint256_t(0x08));
+  pendingState.putBalanceChange(BalanceChangeType::BALANCE_CHANGE_ADD, BalanceAddressType::BALANCE_ADDRESS_CONTRACT, uint256_t(0xB), uint256_t(0x08));
+  uint256_t balanceBeforeRevert = pendingState.balanceWithPendingChanges(uint256_t(0xA), uint256_t(0x00));
+  pendingState.revert(checkpoint);
+
+  // then
+  CHECK(uint256_t(0x08) == balanceBeforeRevert);
+  CHECK(uint256_t(0x10) == pendingState.balanceWithPendingChanges(uint256_t(0xA), uint256_t(0x00)));
+  CHECK(uint256_t(0x05) == pendingState.balanceWithPendingChanges(uint256_t(0xB), uint256_t(0x05)));
+  REQUIRE(1 == pendingState.resolvedBalanceAddresses().size());
+  CHECK(uint256_t(0xA) == pendingState.resolvedBalanceAddresses()[0].address);
+}
+
+TEST_CASE("Resolved account state holds only the last write to each slot", "[pending_state]") {
+
+  // given
+  PendingState pendingState {};
+  pendingState.currentStackDepth = 1;
+  for (uint64_t i = 1; i <= 100; i++) {
+    pendingState.putState(uint256_t(0x00), uint256_t(i), uint256_t(0xA1));
+  }
+  pendingState.putState(uint256_t(0x01), uint256_t(0xF1), uint256_t(0xA1));
+  pendingState.putState(uint256_t(0x00), uint256_t(0xF2), uint256_t(0xA2));
+
+  // when
+  std::vector<account_state_t> resolved = pendingState.resolvedAccountState();
+  std::sort(resolved.begin(), resolved.end(), [](const account_state_t& a, const account_state_t& b) {
+    return a.nonce < b.nonce;
+  });
+
+  // then
+  REQUIRE(3 == resolved.size());
+  CHECK(uint256_t(100) == resolved[0].value);
+  CHECK(uint256_t(0xA1) == resolved[0].codeAddress);
+  CHECK(uint256_t(0xF1) == resolved[1].value);
+  CHECK(uint256_t(0xF2) == resolved[2].value);
+  CHECK(uint256_t(0xA2) == resolved[2].codeAddress);
+}
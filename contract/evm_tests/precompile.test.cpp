@@ -0,0 +1,252 @@
+#include "catch.hpp"
+#include <memory>
+#include <evm/precompile.hpp>
+#include <evm/call.hpp>
+#include <evm/utils.hpp>
+#include <evm/hex.hpp>
+#include "external_mock.hpp"
+#include "test_utils.hpp"
+
+// stores "abc" at memory[29..32), STATICCALLs the given address with it and returns 32 bytes from memory[32..64)
+static bytes_t callWithAbc(uint8_t address, uint8_t gas, bool& success) {
+  std::string gasOp = gas == 0 ? "5a" : "60" + Hex::bytesToHex(bytes_t { gas });
+  bytes_t code = Hex::hexToBytes("62616263600052602060206003601d60" + Hex::bytesToHex(bytes_t { address }) + gasOp + "fa60005260206020f3");
+
+  std::shared_ptr<Context> context = Context::makeCodeCall(
+    Utils::env(), uint256_t(0xea0e9a), 100000, uint256_t(0), uint256_t(0),
+    std::make_shared<bytes_t>(code), std::make_shared<bytes_t>()
+  );
+  std::shared_ptr<ExternalMock> external = std::make_shared<ExternalMock>();
+  std::shared_ptr<PendingState> pendingState = std::make_shared<PendingState>();
+  Operation operation;
+  GasCalculation gasCalculation;
+  Memory memory;
+
+  call_result_t result = Call::call(0, CallType::ACTION_CALL, memory, *context, operation, gasCalculation, external, pendingState);
+  REQUIRE(MessageCallResult::MESSAGE_CALL_RETURN == result.first);
+
+  success = memory.read(0) == 1;
+  MessageCallReturn messageCallReturn = std::get<MessageCallReturn>(result.second);
+  return memory.readSlice(messageCallReturn.offset, messageCallReturn.size);
+}
+
+TEST_CASE("SHA-256 digests", "[precompile]") {
+  CHECK("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" == TestUtils::bytesToHex(Hash::sha256(bytes_t())));
+  CHECK("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" == TestUtils::bytesToHex(Hash::sha256(Hex::hexToBytes("616263"))));
+  CHECK("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" == 
+    TestUtils::bytesToHex(Hash::sha256(Hex::hexToBytes("6162636462636465636465666465666765666768666768696768696a68696a6b696a6b6c6a6b6c6d6b6c6d6e6c6d6e6f6d6e6f706e6f7071")))
+  );
+}
+
+TEST_CASE("RIPEMD-160 digests", "[precompile]") {
+  CHECK("9c1185a5c5e9fc54612808977ee8f548b2258d31" == TestUtils::bytesToHex(Hash::ripemd160(bytes_t())));
+  CHECK("8eb208f7e05d987a9b044a8e98c6b087f15a0bfc" == TestUtils::bytesToHex(Hash::ripemd160(Hex::hexToBytes("616263"))));
+  CHECK("12a053384a9c0c88e405a06c27dcf49ada62eb2b" == 
+    TestUtils::bytesToHex(Hash::ripemd160(Hex::hexToBytes("6162636462636465636465666465666765666768666768696768696a68696a6b696a6b6c6a6b6c6d6b6c6d6e6c6d6e6f6d6e6f706e6f7071")))
+  );
+}
+
+TEST_CASE("Precompile gas", "[precompile]") {
+  bytes_t input(33, 0);
+  CHECK(60 + 12 * 2 == Precompile::gas(uint256_t(2), input));
+  CHECK(600 + 120 * 2 == Precompile::gas(uint256_t(3), input));
+  CHECK(15 + 3 * 2 == Precompile::gas(uint256_t(4), input));
+  CHECK(15 == Precompile::gas(uint256_t(4), bytes_t()));
+  CHECK(3000 == Precompile::gas(uint256_t(1), input));
+}
+
+TEST_CASE("Precompile addresses", "[precompile]") {
+  CHECK(Precompile::exists(uint256_t(1)));
+  CHECK(Precompile::exists(uint256_t(2)));
+  CHECK(Precompile::exists(uint256_t(4)));
+  CHECK(Precompile::exists(uint256_t(9)));
+  CHECK(!Precompile::exists(uint256_t(10)));
+  CHECK(!Precompile::exists(uint256_t(0)));
+  CHECK(!Precompile::exists(uint256_t(0x0102)));
+}
+
+TEST_CASE("Call the SHA-256 precompile", "[precompile]") {
+  bool success;
+  bytes_t output = callWithAbc(0x02, 0, success);
+  CHECK(success);
+  CHECK("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" == TestUtils::bytesToHex(output));
+}
+
+TEST_CASE("Call the RIPEMD-160 precompile", "[precompile]") {
+  bool success;
+  bytes_t output = callWithAbc(0x03, 0, success);
+  CHECK(success);
+  CHECK("0000000000000000000000008eb208f7e05d987a9b044a8e98c6b087f15a0bfc" == TestUtils::bytesToHex(output));
+}
+
+TEST_CASE("Call the identity precompile", "[precompile]") {
+  bool success;
+  bytes_t output = callWithAbc(0x04, 0, success);
+  CHECK(success);
+  // only the three returned bytes are copied over the zeroed output area
+  CHECK("6162630000000000000000000000000000000000000000000000000000000000" == TestUtils::bytesToHex(output));
+}
+
+TEST_CASE("Call a precompile without enough gas", "[precompile]") {
+  bool success;
+  bytes_t output = callWithAbc(0x02, 71, success);
+  CHECK(!success);
+}
+
+static const std::string ECRECOVER_INPUT = "18c547e4f7b0f325ad1e56f57e26c745b09a3e503d86e00e5255ff7f715d3d1c"
+  "000000000000000000000000000000000000000000000000000000000000001c"
+  "73b1693892219d736caba55bdb67216e485557ea6b6af75f37096c9aa6a5a75f"
+  "eeb940b1d03b21e36b0e47e79769f095fe2ab855bd91e3a38756b7d75a9c4549";
+
+TEST_CASE("Recover an address with the ecrecover precompile", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+
+  precompile_result_t result = Precompile::run(uint256_t(1), Hex::hexToBytes(ECRECOVER_INPUT), external, pendingState);
+
+  CHECK(PrecompileResult::PRECOMPILE_SUCCESS == result.first);
+  CHECK("000000000000000000000000a94f5374fce5edbc8e2a8697c15331677e6ebf0b" == TestUtils::bytesToHex(result.second));
+}
+
+TEST_CASE("Unrecoverable ecrecover input succeeds with no output", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+
+  // v = 29
+  std::string badV = ECRECOVER_INPUT;
+  badV.replace(126, 2, "1d");
+  // v = 28 + 2^8
+  std::string wideV = ECRECOVER_INPUT;
+  wideV.replace(124, 2, "01");
+  // s = 0
+  std::string zeroS = ECRECOVER_INPUT.substr(0, 192) + std::string(64, '0');
+
+  for (const std::string& input : { badV, wideV, zeroS, std::string() }) {
+    precompile_result_t result = Precompile::run(uint256_t(1), Hex::hexToBytes(input), external, pendingState);
+    CHECK(PrecompileResult::PRECOMPILE_SUCCESS == result.first);
+    CHECK(result.second.empty());
+  }
+}
+
+TEST_CASE("Repeated ecrecover inputs are recovered once", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+  bytes_t input = Hex::hexToBytes(ECRECOVER_INPUT);
+
+  precompile_result_t first = Precompile::run(uint256_t(1), input, external, pendingState);
+  // trailing bytes past the four words don't change the result
+  input.push_back(0xff);
+  precompile_result_t second = Precompile::run(uint256_t(1), input, external, pendingState);
+
+  CHECK(first.second == second.second);
+  CHECK(1 == external.ecrecoverSpy.size());
+}
+
+static std::string lengths(const std::string& base, const std::string& exponent, const std::string& modulus) {
+  return std::string(64 - base.size(), '0') + base + std::string(64 - exponent.size(), '0') + exponent
+    + std::string(64 - modulus.size(), '0') + modulus;
+}
+
+// EIP-198: 3^(p - 1) mod p for the secp256k1 prime
+static const std::string MODEXP_INPUT = lengths("1", "20", "20") + "03"
+  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2e"
+  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f";
+
+TEST_CASE("Run the modexp precompile", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+
+  precompile_result_t result = Precompile::run(uint256_t(5), Hex::hexToBytes(MODEXP_INPUT), external, pendingState);
+
+  CHECK(PrecompileResult::PRECOMPILE_SUCCESS == result.first);
+  CHECK("0000000000000000000000000000000000000000000000000000000000000001" == TestUtils::bytesToHex(result.second));
+}
+
+TEST_CASE("Modexp reads past the end of its input as zeros", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+
+  // base 3, exponent 5, the modulus 0x64 is followed by a missing zero byte
+  bytes_t input = Hex::hexToBytes(lengths("1", "1", "2") + "030564");
+  precompile_result_t result = Precompile::run(uint256_t(5), input, external, pendingState);
+  CHECK("00f3" == TestUtils::bytesToHex(result.second));
+
+  precompile_result_t empty = Precompile::run(uint256_t(5), Hex::hexToBytes(lengths("1", "1", "0") + "0305"), external, pendingState);
+  CHECK(PrecompileResult::PRECOMPILE_SUCCESS == empty.first);
+  CHECK(empty.second.empty());
+}
+
+TEST_CASE("Modexp gas", "[precompile]") {
+  // 4 words squared, 255 squarings
+  CHECK(1360 == Precompile::gas(uint256_t(5), Hex::hexToBytes(MODEXP_INPUT)));
+  // a 64 byte exponent whose first word is 1
+  CHECK(16 * 256 / 3 == Precompile::gas(uint256_t(5), Hex::hexToBytes(lengths("20", "40", "20") + std::string(64, '0') + std::string(63, '0') + "1")));
+  CHECK(200 == Precompile::gas(uint256_t(5), bytes_t()));
+  CHECK(200 == Precompile::gas(uint256_t(5), Hex::hexToBytes(lengths("0", "ffffffffffffffffffff", "0"))));
+  CHECK(std::numeric_limits<gas_t>::max() == Precompile::gas(uint256_t(5), Hex::hexToBytes(lengths("8000000000000000000000000000000000000000000000000000000000000000", "1", "1"))));
+  CHECK(std::numeric_limits<gas_t>::max() == Precompile::gas(uint256_t(5), Hex::hexToBytes(lengths("1", "ffffffffffffffffffff", "1"))));
+}
+
+TEST_CASE("alt_bn128 gas", "[precompile]") {
+  CHECK(150 == Precompile::gas(uint256_t(6), bytes_t(128, 0)));
+  CHECK(6000 == Precompile::gas(uint256_t(7), bytes_t(96, 0)));
+  CHECK(45000 == Precompile::gas(uint256_t(8), bytes_t()));
+  CHECK(45000 + 2 * 34000 == Precompile::gas(uint256_t(8), bytes_t(384, 0)));
+}
+
+TEST_CASE("Invalid alt_bn128 points fail the call", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+
+  // (1, 3) is not on the curve
+  bytes_t input(128, 0);
+  input[31] = 1;
+  input[63] = 3;
+  CHECK(PrecompileResult::PRECOMPILE_FAILED == Precompile::run(uint256_t(6), input, external, pendingState).first);
+  CHECK(PrecompileResult::PRECOMPILE_FAILED == Precompile::run(uint256_t(8), bytes_t(191, 0), external, pendingState).first);
+
+  precompile_result_t empty = Precompile::run(uint256_t(8), bytes_t(), external, pendingState);
+  CHECK(PrecompileResult::PRECOMPILE_SUCCESS == empty.first);
+  CHECK(uint256_t(1) == BigInt::fromBigEndianBytes(empty.second));
+}
+
+// EIP-152: 12 rounds over "abc", the final block of BLAKE2b-512
+static const std::string BLAKE2F_INPUT = "0000000c"
+  "48c9bdf267e6096a3ba7ca8485ae67bb2bf894fe72f36e3cf1361d5f3af54fa5d182e6ad7f520e511f6c3e2b8c68059b6bbd41fbabd9831f79217e1319cde05b"
+  "6162630000000000000000000000000000000000000000000000000000000000"
+  "0000000000000000000000000000000000000000000000000000000000000000"
+  "0000000000000000000000000000000000000000000000000000000000000000"
+  "0000000000000000000000000000000000000000000000000000000000000000"
+  "03000000000000000000000000000000"
+  "01";
+
+TEST_CASE("Run the blake2f precompile", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+
+  precompile_result_t result = Precompile::run(uint256_t(9), Hex::hexToBytes(BLAKE2F_INPUT), external, pendingState);
+  CHECK(PrecompileResult::PRECOMPILE_SUCCESS == result.first);
+  CHECK("ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d17d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923" == TestUtils::bytesToHex(result.second));
+
+  std::string notFinal = BLAKE2F_INPUT;
+  notFinal.replace(424, 2, "00");
+  result = Precompile::run(uint256_t(9), Hex::hexToBytes(notFinal), external, pendingState);
+  CHECK("75ab69d3190a562c51aef8d88f1c2775876944407270c42c9844252c26d2875298743e7f6d5ea2f2d3e8d226039cd31b4e426ac4f2d3d666a610c2116fde4735" == TestUtils::bytesToHex(result.second));
+}
+
+TEST_CASE("Blake2f gas and malformed input", "[precompile]") {
+  ExternalMock external;
+  PendingState pendingState;
+
+  CHECK(12 == Precompile::gas(uint256_t(9), Hex::hexToBytes(BLAKE2F_INPUT)));
+  CHECK(0xffffffff == Precompile::gas(uint256_t(9), Hex::hexToBytes("ffffffff" + BLAKE2F_INPUT.substr(8))));
+
+  std::string badFlag = BLAKE2F_INPUT;
+  badFlag.replace(424, 2, "02");
+  std::string shortInput = BLAKE2F_INPUT.substr(0, 424);
+  std::string longInput = BLAKE2F_INPUT + "00";
+  for (const std::string& input : { badFlag, shortInput, longInput }) {
+    CHECK(PrecompileResult::PRECOMPILE_FAILED == Precompile::run(uint256_t(9), Hex::hexToBytes(input), external, pendingState).first);
+  }
+  CHECK(0 == Precompile::gas(uint256_t(9), Hex::hexToBytes(shortInput)));
+}
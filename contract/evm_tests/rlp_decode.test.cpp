@@ -348,4 +348,74 @@ TEST_CASE("Payload (1)", "[rlp_decode]") {
   );
 
   delete items;
-}
\ No newline at end of file
+}
+TEST_CASE("String longer than 64KB", "[rlp_decode]") {
+
+  // given
+  bytes_t bytes = { 0xfa, 0x01, 0x00, 0x04, 0xba, 0x01, 0x00, 0x00 };
+  bytes.resize(bytes.size() + 0x10000, 0xab);
+
+  // when
+  rlp_list_t* items = new rlp_list_t();
+  RLPDecode::decode(bytes, items);
+
+  // then
+  REQUIRE(1 == items->size());
+  rlp_list_t list = std::get<rlp_list_t>(items->at(0).value);
+  REQUIRE(1 == list.size());
+  bytes_t decoded = std::get<bytes_t>(list[0].value);
+  CHECK(0x10000 == decoded.size());
+  CHECK(0xab == decoded.back());
+
+  delete items;
+}
+
+TEST_CASE("Reader yields views into the encoded buffer", "[rlp_decode]") {
+
+  // given
+  bytes_t bytes = { 
+    0xc9, 0x83, 'c', 'a', 't',
+    0xc4, 0x83, 'd', 'o', 'g'
+  };
+
+  // when
+  RLPReader reader(bytes);
+  rlp_view_t list;
+  REQUIRE(reader.next(list));
+  RLPReader items(list);
+  rlp_view_t cat;
+  rlp_view_t inner;
+  REQUIRE(items.next(cat));
+  REQUIRE(items.next(inner));
+
+  // then
+  CHECK(RLPType::LIST == list.type);
+  CHECK(10 == list.encodedSize);
+  CHECK(RLPType::STRING == cat.type);
+  CHECK(bytes.data() + 2 == cat.payload);
+  CHECK(3 == cat.payloadSize);
+  CHECK(RLPType::LIST == inner.type);
+  CHECK(bytes.data() + 5 == inner.encoded);
+  CHECK(5 == inner.encodedSize);
+  CHECK_FALSE(items.next(cat));
+  CHECK_FALSE(items.isMalformed());
+  CHECK_FALSE(reader.next(list));
+}
+
+TEST_CASE("Reader stops at an item running past the buffer", "[rlp_decode]") {
+
+  // given
+  bytes_t bytes = { 0x83, 'd', 'o' };
+  bytes_t longLength = { 0xb9, 0xff };
+
+  // when
+  RLPReader reader(bytes);
+  RLPReader longReader(longLength);
+  rlp_view_t item;
+
+  // then
+  CHECK_FALSE(reader.next(item));
+  CHECK(reader.isMalformed());
+  CHECK_FALSE(longReader.next(item));
+  CHECK(longReader.isMalformed());
+}
@@ -0,0 +1,46 @@
+#include "catch.hpp"
+#include <evm/secp256k1.hpp>
+#include <evm/address.hpp>
+#include "test_utils.hpp"
+
+// signed with the private key 45a915e4d060149eb4365960e6a7a45f334393093061116b197e3240065ff2d8
+static const uint256_t HASH = intx::from_string<uint256_t>("0x9750eb627ca3dd6ee70d59578b9bfe3090eed6fa2c51329a1e02d1ba5ee1b8bf");
+static const uint256_t R = intx::from_string<uint256_t>("0xf973a0b87062c389d125d8199e803b832b6ac6bf7867a4f6cd87506060fc4c58");
+static const uint256_t S = intx::from_string<uint256_t>("0x631bf54422ff01659b3388e81024dbb288b852426b47bcf6f7cbbfe9a53b40c9");
+
+TEST_CASE("Recover a public key from a signature", "[secp256k1]") {
+  bytes_t publicKey = Secp256k1::recover(HASH, 0, R, S);
+  CHECK("3a514176466fa815ed481ffad09110a2d344f6c9b78c1d14afc351c3a51be33d8072e77939dc03ba44790779b7a1025baf3003f6732430e20cd9b76d953391b3" ==
+    TestUtils::bytesToHex(publicKey)
+  );
+  CHECK("a94f5374fce5edbc8e2a8697c15331677e6ebf0b" == TestUtils::bytesToHex(Address::ethereumAddress(publicKey)));
+}
+
+TEST_CASE("The other recovery id gives a different key", "[secp256k1]") {
+  bytes_t publicKey = Secp256k1::recover(HASH, 1, R, S);
+  REQUIRE(64 == publicKey.size());
+  CHECK("a94f5374fce5edbc8e2a8697c15331677e6ebf0b" != TestUtils::bytesToHex(Address::ethereumAddress(publicKey)));
+}
+
+TEST_CASE("Reject signatures that can't be recovered", "[secp256k1]") {
+  CHECK(Secp256k1::recover(HASH, 2, R, S).empty());
+  CHECK(Secp256k1::recover(HASH, 0, 0, S).empty());
+  CHECK(Secp256k1::recover(HASH, 0, R, 0).empty());
+  CHECK(Secp256k1::recover(HASH, 0, Secp256k1::N, S).empty());
+  CHECK(Secp256k1::recover(HASH, 0, R, Secp256k1::N).empty());
+  // x = 5 is not on the curve since 5^3 + 7 is not a square
+  CHECK(!Secp256k1::recoverable(HASH, 0, 5, S));
+  CHECK(Secp256k1::recover(HASH, 0, 5, S).empty());
+  CHECK(Secp256k1::recoverable(HASH, 0, R, S));
+}
+
+TEST_CASE("Reject signatures that recover the point at infinity", "[secp256k1]") {
+  // R = 3 G with s = 5 and e = 15, so s R - e G = 0
+  uint256_t r = intx::from_string<uint256_t>("0xf9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9");
+  CHECK(!Secp256k1::recoverable(15, 0, r, 5));
+  CHECK(Secp256k1::recover(15, 0, r, 5).empty());
+  // the other y, and a different hash, recover normally
+  CHECK(Secp256k1::recoverable(15, 1, r, 5));
+  CHECK(Secp256k1::recoverable(16, 0, r, 5));
+  CHECK(64 == Secp256k1::recover(16, 0, r, 5).size());
+}
@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include <evm/secp256k1_field.hpp>
+#include <evm/decompress_key.hpp>
+#include <evm/hash.hpp>
+#include "test_utils.hpp"
+
+static const uint256_t P = intx::from_string<uint256_t>("0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f");
+
+static std::vector<uint256_t> fieldSamples() {
+  std::vector<uint256_t> samples = { 0, 1, 2, 7, P - 1, P - 2, P >> 1, uint256_t(1) << 255, ~uint256_t(0) };
+  uint256_t seed = 0x5089107a9fca38bcULL;
+  for (size_t i = 0; i < 16; i++) {
+    seed = Hash::keccak256Word(BigInt::toBytes(seed));
+    samples.push_back(seed);
+  }
+  return samples;
+}
+
+TEST_CASE("Field elements are reduced modulo p", "[secp256k1_field]") {
+  CHECK(uint256_t(0) == Secp256k1Field(P).word());
+  CHECK(uint256_t(1) == Secp256k1Field(P + 1).word());
+  CHECK(~uint256_t(0) - P == Secp256k1Field(~uint256_t(0)).word());
+}
+
+TEST_CASE("Field addition and multiplication match mulmod", "[secp256k1_field]") {
+  std::vector<uint256_t> samples = fieldSamples();
+  for (const uint256_t& a : samples) {
+    for (const uint256_t& b : samples) {
+      uint256_t x = a % P;
+      uint256_t y = b % P;
+      CHECK(intx::mulmod(x, y, P) == (Secp256k1Field(a) * Secp256k1Field(b)).word());
+      CHECK(intx::addmod(x, y, P) == (Secp256k1Field(a) + Secp256k1Field(b)).word());
+    }
+  }
+}
+
+TEST_CASE("Field negation", "[secp256k1_field]") {
+  for (const uint256_t& a : fieldSamples()) {
+    Secp256k1Field x(a);
+    CHECK(Secp256k1Field() == x + x.negate());
+  }
+}
+
+TEST_CASE("Field square root of a square", "[secp256k1_field]") {
+  for (const uint256_t& a : fieldSamples()) {
+    Secp256k1Field square = Secp256k1Field(a).square();
+    Secp256k1Field root = square.sqrt();
+    CHECK(square == root.square());
+  }
+}
+
+TEST_CASE("Decompress a compressed key with an odd y", "[secp256k1_field]") {
+
+  // given the generator point
+  bytes_t compressedKeyBytes = Hex::hexToBytes("0379be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
+  std::array<char, 33> compressedKey;
+  for (int i = 0; i < compressedKeyBytes.size(); i++) {
+    compressedKey[i] = compressedKeyBytes[i];
+  }
+
+  // when
+  bytes_t decompressedKey = DecompressKey::decompress(compressedKey);
+
+  // then
+  CHECK("79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798b7c52588d95c3b9aa25b0403f1eef75702e84bb7597aabe663b82f6f04ef2777" ==
+    TestUtils::bytesToHex(decompressedKey)
+  );
+}
+
+TEST_CASE("Field inverse", "[secp256k1_field]") {
+  for (const uint256_t& sample : fieldSamples()) {
+    Secp256k1Field a(sample);
+    if (a == Secp256k1Field()) continue;
+    CHECK(uint256_t(1) == (a * a.inverse()).word());
+  }
+}
@@ -269,4 +269,157 @@ TEST_CASE("Signature bytes with leading 0's in R component", "[transaction)]") {
   );
 
   delete rlp;
-}
\ No newline at end of file
+}
+TEST_CASE("Transaction view matches the field accessors", "[transaction)]") {
+
+  // given
+  std::string hex = "f901958203fa85028fa6ae00830b5b519477598616174a411ae9a1e197640903faab9ac1ae880113806225a3c428b9012459f9cf0c000000000000000000000000000000000000000000000000000000000000004b00000000000000000000000000000000000000000000000000000000000000450000000000000000000000000000000000000000000000000000000000000080000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000a00000000000000000000000000000000000000000000000000000000000000041d2eaa477e07126513ab0c83723174b5e2e921382f216647f3cd0b88bffb97faf1767bd51418804947913b905809be585882f350bb272275943e4efdede347c421b0000000000000000000000000000000000000000000000000000000000000025a06a744032ad48eb8188d2f03ccc57bf9d91a45f780152288ee7abb700ee286393a02c2171570feb5e6855a62c4a9562b219ea4daeea98376a06f170e352035d353c";
+  bytes_t encoded = Hex::hexToBytes(hex);
+  rlp_list_t* rlp = new rlp_list_t();
+  RLPDecode::decode(encoded, rlp);
+
+  // when
+  transaction_view_t tx;
+  bool parsed = Transaction::parse(encoded, tx);
+
+  // then
+  CHECK(parsed);
+  CHECK(Transaction::type(rlp) == tx.type);
+  CHECK(Transaction::nonce(rlp) == tx.nonce);
+  CHECK(Transaction::gasPrice(rlp) == tx.gasPrice);
+  CHECK(Transaction::gas(rlp) == tx.gas);
+  CHECK(BigInt::fromBigEndianBytes(Transaction::address(rlp)) == tx.to);
+  CHECK(Transaction::value(rlp) == tx.value);
+  CHECK(Transaction::data(rlp) == bytes_t(tx.data, tx.data + tx.dataSize));
+  CHECK(Transaction::v(rlp) == tx.v);
+  CHECK(Transaction::r(rlp) == tx.r);
+  CHECK(Transaction::s(rlp) == tx.s);
+  CHECK(tx.hasSignature);
+  CHECK(Transaction::signature(rlp, 1) == tx.signature);
+  CHECK(Transaction::digest(rlp, 0x01) == tx.digest);
+
+  delete rlp;
+}
+
+TEST_CASE("Transaction view signature and digest", "[transaction)]") {
+
+  // given
+  std::string hex = "f855018203e88207d0808088000000000000000025a06db1bf318e29ca002dc5314af1c0d1722659ad2dcb79357d7b7746aa5510afdaa0336e5414d221f6280598a5ac338a17331e2b925bd6ca693d85961248acefea72";
+  bytes_t encoded = Hex::hexToBytes(hex);
+
+  // when
+  transaction_view_t tx;
+  bool parsed = Transaction::parse(encoded, tx);
+
+  // then
+  CHECK(parsed);
+  CHECK(TransactionActionType::TRANSACTION_CREATE == tx.type);
+  CHECK(8 == tx.dataSize);
+  CHECK("1b6db1bf318e29ca002dc5314af1c0d1722659ad2dcb79357d7b7746aa5510afda336e5414d221f6280598a5ac338a17331e2b925bd6ca693d85961248acefea72" == 
+    TestUtils::bytesToHex(tx.signature)
+  );
+  CHECK("699f057e0ec6cf7ee1986c47e518b42ac4bdfe007c415097638c3b7166b65063" ==
+    TestUtils::bytesToHex(tx.digest)
+  );
+}
+
+TEST_CASE("Transaction view of an unsigned transaction", "[transaction)]") {
+
+  // given
+  bytes_t encoded = Hex::hexToBytes("e6808609184e72a0008303000094b0920c523d582040f2bcb1bd7fb1c7c1ecebdb3480801c8080");
+
+  // when
+  transaction_view_t tx;
+  bool parsed = Transaction::parse(encoded, tx);
+
+  // then
+  CHECK(parsed);
+  CHECK(!tx.hasSignature);
+  CHECK(0 == tx.signature.size());
+  CHECK(uint256_t(0x030000) == tx.gas);
+  CHECK(intx::from_string<uint256_t>("0xb0920c523d582040f2bcb1bd7fb1c7c1ecebdb34") == tx.to);
+}
+
+TEST_CASE("Transaction view rejects malformed encodings", "[transaction)]") {
+
+  transaction_view_t tx;
+
+  // truncated
+  CHECK(!Transaction::parse(Hex::hexToBytes("e6808609184e72a0008303000094b0920c523d582040f2bcb1bd7fb1c7c1ecebdb3480801c80"), tx));
+  // trailing bytes after the list
+  CHECK(!Transaction::parse(Hex::hexToBytes("e6808609184e72a0008303000094b0920c523d582040f2bcb1bd7fb1c7c1ecebdb3480801c808000"), tx));
+  // eight fields
+  CHECK(!Transaction::parse(Hex::hexToBytes("e5808609184e72a0008303000094b0920c523d582040f2bcb1bd7fb1c7c1ecebdb3480801c80"), tx));
+  // 21 byte address
+  CHECK(!Transaction::parse(Hex::hexToBytes("e7808609184e72a0008303000095b0920c523d582040f2bcb1bd7fb1c7c1ecebdb340080801c8080"), tx));
+  // a list where a field should be
+  CHECK(!Transaction::parse(Hex::hexToBytes("c9c080808080808080c0"), tx));
+  // not a list
+  CHECK(!Transaction::parse(Hex::hexToBytes("8180"), tx));
+}
+
+TEST_CASE("Transaction view digest with a two byte chain id", "[transaction)]") {
+
+  // given
+  std::string hex = "f855018203e88207d0808088000000000000000025a06db1bf318e29ca002dc5314af1c0d1722659ad2dcb79357d7b7746aa5510afdaa0336e5414d221f6280598a5ac338a17331e2b925bd6ca693d85961248acefea72";
+  bytes_t encoded = Hex::hexToBytes(hex);
+  rlp_list_t* rlp = new rlp_list_t();
+  RLPDecode::decode(encoded, rlp);
+
+  // when
+  transaction_view_t tx;
+  Transaction::parse(encoded, tx);
+
+  // then
+  CHECK(Transaction::digest(rlp, 0x00) == Transaction::digest(tx, 0x00));
+  CHECK(Transaction::digest(rlp, 0x7f) == Transaction::digest(tx, 0x7f));
+  CHECK(Transaction::digest(rlp, 0x80) == Transaction::digest(tx, 0x80));
+  CHECK(Transaction::digest(rlp, 0xff) == Transaction::digest(tx, 0xff));
+
+  delete rlp;
+}
+
+TEST_CASE("Transaction view rejects non-canonical fields", "[transaction)]") {
+
+  transaction_view_t tx;
+
+  // nonce 0x01 written as a one byte string
+  CHECK(!Transaction::parse(Hex::hexToBytes("e781018609184e72a0008303000094b0920c523d582040f2bcb1bd7fb1c7c1ecebdb3480801c8080"), tx));
+  // empty data written with a long string header
+  CHECK(!Transaction::parse(Hex::hexToBytes("e7808609184e72a0008303000094b0920c523d582040f2bcb1bd7fb1c7c1ecebdb3480b8001c8080"), tx));
+}
+
+TEST_CASE("Transaction intrinsic gas", "[transaction)]") {
+
+  // value transfer without data, and a create with eight zero bytes of data
+  bytes_t callBytes = Hex::hexToBytes("e6808609184e72a0008303000094b0920c523d582040f2bcb1bd7fb1c7c1ecebdb3480801c8080");
+  bytes_t createBytes = Hex::hexToBytes("f855018203e88207d0808088000000000000000025a06db1bf318e29ca002dc5314af1c0d1722659ad2dcb79357d7b7746aa5510afdaa0336e5414d221f6280598a5ac338a17331e2b925bd6ca693d85961248acefea72");
+
+  transaction_view_t call;
+  transaction_view_t create;
+  Transaction::parse(callBytes, call);
+  Transaction::parse(createBytes, create);
+
+  CHECK(21000 == Transaction::intrinsicGas(call));
+  CHECK(21000 + 32000 + 8 * 4 == Transaction::intrinsicGas(create));
+}
+
+TEST_CASE("Transaction upfront cost", "[transaction)]") {
+
+  bytes_t encoded = Hex::hexToBytes("f85f800182520894095e7baea6a6c7c4c2dfeb977efac326af552d870a801ba048b55bfa915ac795c431978d8a6a992b628d557da5ff759b307d495a36649353a0efffd310ac743f371de3b9f7f9cb56c0b28ad43601b4ab949f53faa07bd2c804");
+  transaction_view_t tx;
+  Transaction::parse(encoded, tx);
+
+  std::pair<uint256_t, bool> cost = Transaction::upfrontCost(tx);
+  CHECK(!cost.second);
+  CHECK(uint256_t(0x5208 + 0x0a) == cost.first);
+
+  tx.gasPrice = std::numeric_limits<uint256_t>::max() / 2;
+  CHECK(Transaction::upfrontCost(tx).second);
+
+  tx.gasPrice = 0;
+  tx.value = std::numeric_limits<uint256_t>::max();
+  CHECK(!Transaction::upfrontCost(tx).second);
+  tx.gasPrice = 1;
+  CHECK(Transaction::upfrontCost(tx).second);
+}
@@ -12,19 +12,17 @@
 
 class eos_ecrecover {
   public:
-    static bytes_t recover(std::string accountName, rlp_list_t* rlp, const env_t& env) {
+    static bytes_t recover(std::string accountName, const transaction_view_t& tx) {
 
-      bytes_t digest = Transaction::digest(rlp, 0x01);
       std::array<uint8_t, 32> digestData;
-      for (int i = 0; i < digest.size(); i++) {
-        digestData[i] = digest[i];
+      for (int i = 0; i < tx.digest.size(); i++) {
+        digestData[i] = tx.digest[i];
       }
       eosio::fixed_bytes<32> digestBytes(digestData);
 
-      bytes_t signature = Transaction::signature(rlp, env.chainId);
       std::array<char, 65> signatureData;
-      for (int i = 0; i < signature.size(); i++) {
-        signatureData[i] = signature[i];
+      for (int i = 0; i < tx.signature.size(); i++) {
+        signatureData[i] = tx.signature[i];
       }
       eosio::signature signatureBytes(std::in_place_index<0>, signatureData);
 
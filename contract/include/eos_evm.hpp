@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <map>
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 
@@ -9,6 +10,22 @@
 using namespace std;
 using namespace eosio;
 
+class eos_state_cache;
+
+/*
+  State shared by the transactions of one action. Nothing is written back until the batch
+  commits, so the cached rows stay valid and PendingState carries every transaction's changes.
+*/
+struct transaction_batch {
+  env_t env;
+  std::shared_ptr<Operation> operation; // built by the first transaction that runs code
+  std::shared_ptr<GasCalculation> gasCalculation;
+  std::shared_ptr<PendingState> pendingState;
+  std::shared_ptr<eos_state_cache> cache;
+  std::shared_ptr<External> external;
+  std::map<uint64_t, uint64_t> executed; // transactions executed per account primary key
+};
+
 class [[eosio::contract("eos_evm")]] eos_evm : public contract {
   public:
     static constexpr eosio::symbol CONTRACT_SYMBOL = eosio::symbol{"EVM", 4};
@@ -48,31 +65,127 @@ class [[eosio::contract("eos_evm")]] eos_evm : public contract {
       indexed_by<name("stateid"), const_mem_fun<account_state, checksum256, &account_state::tertiary_key>>
     > account_state_table;
 
+    /*
+      Contract storage, scoped by the low 64 bits of the contract address. The primary key is the
+      first 8 bytes of the composite key; on a collision the next free primary key is used, so
+      lookups probe forward until they find the composite key or an empty primary key.
+      A row is only read while its generation matches the contract's account_code row, so the
+      storage of a destroyed or re-created contract reads as zero.
+    */
+    struct [[eosio::table]] contract_state {
+      uint64_t pk;
+      uint64_t generation;
+      checksum256 key;
+      checksum256 value;
+
+      uint64_t primary_key() const { return pk; }
+    };
+
+    typedef multi_index<name("slots"), contract_state> contract_state_table;
+
+    // the generation handed to the next account_code row, ids are never reused
+    struct [[eosio::table]] storage_generation {
+      uint64_t pk;
+      uint64_t next;
+
+      uint64_t primary_key() const { return pk; }
+    };
+
+    typedef multi_index<name("storagegen"), storage_generation> storage_generation_table;
+
+    static uint64_t stateScope(const uint256_t& codeAddress) {
+      return static_cast<uint64_t>(codeAddress);
+    }
+
+    static uint64_t slotPrimaryKey(const checksum256& compositeKey) {
+      auto bytes = compositeKey.extract_as_byte_array();
+      uint64_t pk = 0;
+      for (int i = 0; i < 8; i++) pk = (pk << 8) | bytes[i];
+      return pk;
+    }
+
+    // the row holding compositeKey, or end(); pk is left at the row or at the first free key
+    static contract_state_table::const_iterator findSlot(
+      const contract_state_table& table, 
+      const checksum256& compositeKey, 
+      uint64_t& pk
+    ) {
+      pk = slotPrimaryKey(compositeKey);
+      auto itr = table.find(pk);
+      while (itr != table.end() && itr->key != compositeKey) itr = table.find(++pk);
+      return itr;
+    }
+
     struct [[eosio::table]] account_code {
       uint64_t pk;
       checksum256 owner;
       checksum256 address;
       uint64_t nonce;
-      bytes_t code;
+      checksum256 codeHash;
+      uint64_t codeSize;
       checksum256 balance;
+      uint64_t generation;
 
       auto primary_key() const { return pk; }
       checksum256 secondary_key() const { return owner; }
       checksum256 tertiary_key() const { return address; }
+      uint64_t generation_key() const { return generation; }
     };
 
     typedef multi_index<
-      name("accountcode"), 
+      name("codeaccounts"), 
       account_code, 
       indexed_by<name("owneraddress"), const_mem_fun<account_code, checksum256, &account_code::secondary_key>>,
-      indexed_by<name("codeaddress"), const_mem_fun<account_code, checksum256, &account_code::tertiary_key>>
+      indexed_by<name("codeaddress"), const_mem_fun<account_code, checksum256, &account_code::tertiary_key>>,
+      indexed_by<name("generation"), const_mem_fun<account_code, uint64_t, &account_code::generation_key>>
     > account_code_table;
 
+    // the layout before bytecode moved to contract_code, only read by migratecode
+    struct [[eosio::table]] legacy_account_code {
+      uint64_t pk;
+      checksum256 owner;
+      checksum256 address;
+      uint64_t nonce;
+      bytes_t code;
+      checksum256 balance;
+
+      auto primary_key() const { return pk; }
+      checksum256 secondary_key() const { return owner; }
+      checksum256 tertiary_key() const { return address; }
+    };
+
+    typedef multi_index<
+      name("accountcode"), 
+      legacy_account_code, 
+      indexed_by<name("owneraddress"), const_mem_fun<legacy_account_code, checksum256, &legacy_account_code::secondary_key>>,
+      indexed_by<name("codeaddress"), const_mem_fun<legacy_account_code, checksum256, &legacy_account_code::tertiary_key>>
+    > legacy_account_code_table;
+
+    struct [[eosio::table]] contract_code {
+      uint64_t pk;
+      checksum256 codeHash;
+      uint64_t codeSize;
+      uint64_t references;
+      bytes_t code;
+
+      uint64_t primary_key() const { return pk; }
+      checksum256 secondary_key() const { return codeHash; }
+    };
+
+    typedef multi_index<
+      name("contractcode"), 
+      contract_code, 
+      indexed_by<name("codehash"), const_mem_fun<contract_code, checksum256, &contract_code::secondary_key>>
+    > contract_code_table;
+
     eos_evm(name receiver, name code, datastream<const char *> ds): contract(receiver, code, ds) { }
 
     [[eosio::action]]
     void raw(name from, bytes_t code, string sender);
 
+    [[eosio::action]]
+    void rawbatch(name from, std::vector<bytes_t> txs);
+
     [[eosio::action]]
     void execute(name from, bytes_t code, string sender, bytes_t bytecode);
 
@@ -82,12 +195,35 @@ class [[eosio::contract("eos_evm")]] eos_evm : public contract {
     [[eosio::action]]
     void withdraw(name to, asset quantity);
 
+    [[eosio::action]]
+    void migratecode(uint64_t limit);
+
+    [[eosio::action]]
+    void migratestate(uint64_t limit);
+
+    [[eosio::action]]
+    void gcstate(uint64_t scope, uint64_t start, uint64_t limit);
+
     [[eosio::on_notify("eosio.token::transfer")]]
     void transfer(name from, name to, asset quantity, string memo);
 
+    checksum256 storeCode(const name& payer, const bytes_t& code);
+    void releaseCode(const checksum256& codeHash);
+    uint64_t nextGeneration(const name& payer);
+    uint64_t storageGeneration(const uint256_t& codeAddress) const;
+
   private:
-    void incomingTransaction(const name& from, const bytes_t& transaction, const string& sender, const bytes_t& bytecode);
-    void checkCallResult(const name& from, call_result_t callResult, std::shared_ptr<Memory> memory);
+    transaction_batch startBatch();
+    void incomingTransaction(
+      const name& from, 
+      const bytes_t& transaction, 
+      const string& sender, 
+      const bytes_t& bytecode, 
+      transaction_batch& batch, 
+      const string& label
+    );
+    void commitBatch(const name& from, transaction_batch& batch);
+    string callResultStatus(call_result_t callResult, std::shared_ptr<Memory> memory);
     void resolveAccountState(const name& from, std::shared_ptr<PendingState> pendingState);
-    void resolveLogs(std::shared_ptr<PendingState> pendingState, std::shared_ptr<External> external);
+    void resolveLogs(std::shared_ptr<PendingState> pendingState, std::shared_ptr<External> external, const string& label);
 };
\ No newline at end of file
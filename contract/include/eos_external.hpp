@@ -1,14 +1,19 @@
 #include <vector>
 #include <memory>
 #include <eosio/eosio.hpp>
+#include <eosio/crypto.hpp>
+#include <eosio/fixed_bytes.hpp>
 #include <eos_evm.hpp>
 #include <evm/types.h>
 #include <evm/external.h>
 #include <evm/hash.hpp>
+#include <evm/secp256k1.hpp>
+#include <evm/decompress_key.hpp>
 #include <evm/hex.hpp>
 #include <evm/overflow.hpp>
 #include <evm/pending_state.hpp>
 #include <evm/utils.hpp>
+#include <eos_state_cache.hpp>
 
 class eos_external: public External {
   private:
@@ -16,6 +21,7 @@ class eos_external: public External {
     uint256_t _senderAddress;
     name _sender;
     uint256_t _senderAccountBalance;
+    std::shared_ptr<eos_state_cache> _cache;
     
     emplace_t outgoingTransfer(
       const uint256_t& toAddressWord, 
@@ -32,12 +38,7 @@ class eos_external: public External {
         value
       );
 
-      address_t toAddress = BigInt::toFixed32(toAddressWord);
-
-      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto accountCodeItr = accountCodeIdx.find(toAddress);
-      if (accountCodeItr != accountCodeIdx.end()) {
+      if (_cache->codeAccount(toAddressWord).exists) {
         pendingState->putBalanceChange(
           BalanceChangeType::BALANCE_CHANGE_ADD,
           BalanceAddressType::BALANCE_ADDRESS_CONTRACT,
@@ -47,10 +48,7 @@ class eos_external: public External {
         return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
       }
 
-      eos_evm::account_table _account(_contract->get_self(), _contract->get_self().value);
-      auto accountIdx = _account.get_index<name("accountid")>();
-      auto accountItr = accountIdx.find(toAddress);
-      if (accountItr != accountIdx.end()) {
+      if (_cache->account(toAddressWord).exists) {
         pendingState->putBalanceChange(
           BalanceChangeType::BALANCE_CHANGE_ADD,
           BalanceAddressType::BALANCE_ADDRESS_ACCOUNT,
@@ -69,15 +67,10 @@ class eos_external: public External {
       const uint256_t& value,
       std::shared_ptr<PendingState> pendingState
     ) {
-      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto senderAccountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto senderAccountCodeItr = senderAccountCodeIdx.find(BigInt::toFixed32(senderAddressWord));
-      if (senderAccountCodeItr == senderAccountCodeIdx.end()) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
+      const cached_code_account& senderAccountCode = _cache->codeAccount(senderAddressWord);
+      if (!senderAccountCode.exists) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
 
-      uint256_t senderBalance = pendingState->balanceWithPendingChanges(
-        senderAddressWord,
-        BigInt::fromFixed32(senderAccountCodeItr->balance.extract_as_byte_array())
-      );
+      uint256_t senderBalance = pendingState->balanceWithPendingChanges(senderAddressWord, senderAccountCode.balance);
 
       if (senderBalance < value) return std::make_pair(EmplaceResult::EMPLACE_INSUFFICIENT_FUNDS, 0);
 
@@ -88,9 +81,7 @@ class eos_external: public External {
         value
       );
 
-      auto toAccountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto toAccountCodeItr = toAccountCodeIdx.find(BigInt::toFixed32(toAddressWord));
-      if (toAccountCodeItr != toAccountCodeIdx.end()) {
+      if (_cache->codeAccount(toAddressWord).exists) {
         pendingState->putBalanceChange(
           BalanceChangeType::BALANCE_CHANGE_ADD,
           BalanceAddressType::BALANCE_ADDRESS_CONTRACT,
@@ -100,10 +91,7 @@ class eos_external: public External {
         return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
       }
 
-      eos_evm::account_table _account(_contract->get_self(), _contract->get_self().value);
-      auto toAccountIdx = _account.get_index<name("accountid")>();
-      auto toAccountItr = toAccountIdx.find(BigInt::toFixed32(toAddressWord));
-      if (toAccountItr != toAccountIdx.end()) {
+      if (_cache->account(toAddressWord).exists) {
         pendingState->putBalanceChange(
           BalanceChangeType::BALANCE_CHANGE_ADD,
           BalanceAddressType::BALANCE_ADDRESS_ACCOUNT,
@@ -121,15 +109,10 @@ class eos_external: public External {
       const uint256_t& value,
       std::shared_ptr<PendingState> pendingState
     ) {
-      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto senderAccountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto senderAccountCodeItr = senderAccountCodeIdx.find(BigInt::toFixed32(senderAddress));
-      if (senderAccountCodeItr == senderAccountCodeIdx.end()) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
+      const cached_code_account& senderAccountCode = _cache->codeAccount(senderAddress);
+      if (!senderAccountCode.exists) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
 
-      uint256_t senderBalance = pendingState->balanceWithPendingChanges(
-        senderAddress,
-        BigInt::fromFixed32(senderAccountCodeItr->balance.extract_as_byte_array())
-      );
+      uint256_t senderBalance = pendingState->balanceWithPendingChanges(senderAddress, senderAccountCode.balance);
 
       if (senderBalance < value) return std::make_pair(EmplaceResult::EMPLACE_INSUFFICIENT_FUNDS, 0);
 
@@ -155,15 +138,10 @@ class eos_external: public External {
       const uint256_t& endowment,
       std::shared_ptr<PendingState> pendingState
     ) {
-      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(ownerAddressWord));
-      if (accountCodeItr == accountCodeIdx.end()) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
+      const cached_code_account& ownerAccountCode = _cache->codeAccount(ownerAddressWord);
+      if (!ownerAccountCode.exists) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
       
-      uint256_t ownerBalance = pendingState->balanceWithPendingChanges(
-        ownerAddressWord, 
-        BigInt::fromFixed32(accountCodeItr->balance.extract_as_byte_array())
-      );
+      uint256_t ownerBalance = pendingState->balanceWithPendingChanges(ownerAddressWord, ownerAccountCode.balance);
 
       if (ownerBalance < endowment) return std::make_pair(EmplaceResult::EMPLACE_INSUFFICIENT_FUNDS, 0);
       
@@ -182,9 +160,11 @@ class eos_external: public External {
       eos_evm* contract, 
       const uint256_t& senderAddress,
       const name& sender, 
-      const uint256_t& senderAccountBalance
+      const uint256_t& senderAccountBalance,
+      std::shared_ptr<eos_state_cache> cache
     ) {
       _contract = contract;
+      _cache = cache;
       _senderAddress = senderAddress;
       _sender = sender;
       _senderAccountBalance = senderAccountBalance;
@@ -206,52 +186,73 @@ class eos_external: public External {
     }
 
     bytes_t code(const uint256_t& address, std::shared_ptr<PendingState> pendingState) {
-      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(address));
-      if (accountCodeItr != accountCodeIdx.end() && pendingState->contractExists(address)) return accountCodeItr->code;
+      const cached_code_account& accountCode = _cache->codeAccount(address);
+      if (accountCode.exists && accountCode.codeSize > 0 && pendingState->contractExists(address)) 
+        return _cache->code(accountCode.codeHash);
       return bytes_t();
     }
 
+    uint64_t codeSize(const uint256_t& address, std::shared_ptr<PendingState> pendingState) {
+      const cached_code_account& accountCode = _cache->codeAccount(address);
+      if (accountCode.exists && pendingState->contractExists(address)) return accountCode.codeSize;
+      return 0;
+    }
+
+    uint256_t codeHash(const uint256_t& address, std::shared_ptr<PendingState> pendingState) {
+      const cached_code_account& accountCode = _cache->codeAccount(address);
+      if (accountCode.exists && pendingState->contractExists(address)) return accountCode.codeHash;
+      return EMPTY_CODE_HASH;
+    }
+
     uint256_t balance(const uint256_t& addressWord, std::shared_ptr<PendingState> pendingState) {
 
       if (addressWord == _senderAddress) 
         return pendingState->balanceWithPendingChanges(_senderAddress, _senderAccountBalance);
 
-      address_t address = BigInt::toFixed32(addressWord);
+      const cached_code_account& accountCode = _cache->codeAccount(addressWord);
+      if (accountCode.exists) return pendingState->balanceWithPendingChanges(addressWord, accountCode.balance);
 
-      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto accountCodeItr = accountCodeIdx.find(address);
-      if (accountCodeItr != accountCodeIdx.end()) {
-        uint256_t balance = BigInt::fromFixed32(accountCodeItr->balance.extract_as_byte_array());
-        return pendingState->balanceWithPendingChanges(
-          addressWord,
-          BigInt::fromFixed32(accountCodeItr->balance.extract_as_byte_array())
-        );
-      }
-
-      eos_evm::account_table _account(_contract->get_self(), _contract->get_self().value);
-      auto accountIdx = _account.get_index<name("accountid")>();
-      auto accountItr = accountIdx.find(address);
-      if (accountItr != accountIdx.end()) {
-        return pendingState->balanceWithPendingChanges(
-          addressWord,
-          BigInt::fromFixed32(accountItr->balance.extract_as_byte_array())
-        );
-      }
+      const cached_account& account = _cache->account(addressWord);
+      if (account.exists) return pendingState->balanceWithPendingChanges(addressWord, account.balance);
 
       return uint256_t(0);
     }
 
+    bytes_t sha256(const bytes_t& input) {
+      std::array<uint8_t, 32> hash = eosio::sha256(reinterpret_cast<const char*>(input.data()), input.size()).extract_as_byte_array();
+      return bytes_t(hash.begin(), hash.end());
+    }
+
+    bytes_t ripemd160(const bytes_t& input) {
+      std::array<uint8_t, 20> hash = eosio::ripemd160(reinterpret_cast<const char*>(input.data()), input.size()).extract_as_byte_array();
+      return bytes_t(hash.begin(), hash.end());
+    }
+
+    /*
+      The host aborts the action on a signature it can't recover from, including one whose key
+      is the point at infinity, so anything that can't recover is turned away here first and
+      only valid signatures reach recover_key.
+    */
+    bytes_t ecrecover(const uint256_t& hash, uint8_t recoveryId, const uint256_t& r, const uint256_t& s) {
+      if (!Secp256k1::recoverable(hash, recoveryId, r, s)) return bytes_t();
+
+      std::array<uint8_t, 32> digestData = BigInt::toFixed32(hash);
+      eosio::fixed_bytes<32> digestBytes(digestData);
+
+      std::array<char, 65> signatureData;
+      signatureData[0] = recoveryId + 27;
+      std::array<uint8_t, 32> rData = BigInt::toFixed32(r);
+      std::array<uint8_t, 32> sData = BigInt::toFixed32(s);
+      std::copy(rData.begin(), rData.end(), signatureData.begin() + 1);
+      std::copy(sData.begin(), sData.end(), signatureData.begin() + 33);
+      eosio::signature signatureBytes(std::in_place_index<0>, signatureData);
+
+      std::array<char, 33> compressedPubKey = std::get<0>(eosio::recover_key(digestBytes, signatureBytes));
+      return DecompressKey::decompress(compressedPubKey);
+    }
+
     uint256_t storageAt(const uint256_t& key, const uint256_t& codeAddress) {
-      address_t address = BigInt::toFixed32(codeAddress);
-      uint256_t compositeKey = Hash::keccak256WordPair(codeAddress, key);
-      eos_evm::account_state_table _account_state(_contract->get_self(), _contract->get_self().value);
-      auto idx = _account_state.get_index<name("statekey")>();
-      auto itr = idx.find(BigInt::toFixed32(compositeKey));
-      if (itr == idx.end()) return uint256_t(0); 
-      return BigInt::fromFixed32(itr->value.extract_as_byte_array());
+      return _cache->storageAt(key, codeAddress);
     }
 
     emplace_t selfdestruct(
@@ -262,13 +263,16 @@ class eos_external: public External {
 
       pendingState->putSelfDestruct(contractAddressWord);
 
-      address_t contractAddress = BigInt::toFixed32(contractAddressWord);
-
-      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto accountCodeItr = accountCodeIdx.find(contractAddress);
-      if (accountCodeItr == accountCodeIdx.end()) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
-      uint256_t refundBalance = BigInt::fromFixed32(accountCodeItr->balance.extract_as_byte_array());
+      const cached_code_account& contractCode = _cache->codeAccount(contractAddressWord);
+      if (!contractCode.exists) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
+      // the balance including value received earlier in the batch, emptied so a second SELFDESTRUCT refunds nothing
+      uint256_t refundBalance = pendingState->balanceWithPendingChanges(contractAddressWord, contractCode.balance);
+      pendingState->putBalanceChange(
+        BalanceChangeType::BALANCE_CHANGE_SUBTRACT,
+        BalanceAddressType::BALANCE_ADDRESS_CONTRACT, 
+        contractAddressWord,
+        refundBalance
+      );
 
       if (_senderAddress == refundAddressWord) {
         pendingState->putBalanceChange(
@@ -279,10 +283,7 @@ class eos_external: public External {
         );
         return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
       } else {
-        eos_evm::account_table _account(_contract->get_self(), _contract->get_self().value);
-        auto accountIdx = _account.get_index<name("accountid")>();
-        auto accountItr = accountIdx.find(BigInt::toFixed32(refundAddressWord));
-        if (accountItr != accountIdx.end()) {
+        if (_cache->account(refundAddressWord).exists) {
           pendingState->putBalanceChange(
             BalanceChangeType::BALANCE_CHANGE_ADD,
             BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, 
@@ -292,10 +293,7 @@ class eos_external: public External {
           return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
         }
 
-        eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-        auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-        auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(refundAddressWord));
-        if (accountCodeItr != accountCodeIdx.end()) {
+        if (_cache->codeAccount(refundAddressWord).exists) {
           pendingState->putBalanceChange(
             BalanceChangeType::BALANCE_CHANGE_ADD,
             BalanceAddressType::BALANCE_ADDRESS_CONTRACT, 
@@ -321,14 +319,14 @@ class eos_external: public External {
     };
 
     uint256_t incrementContractNonce(const uint256_t& address) { 
+      cached_code_account& accountCode = _cache->codeAccount(address);
+      if (!accountCode.exists) return uint256_t(0);
+      uint64_t nextNonce = accountCode.nonce + 1;
       eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(address));
-      if (accountCodeItr == accountCodeIdx.end()) return uint256_t(0);
-      uint64_t nextNonce = accountCodeItr->nonce + 1;
-      accountCodeIdx.modify(accountCodeItr, _sender, [&](auto& account_code) {
+      _account_code.modify(_account_code.get(accountCode.pk), _sender, [&](auto& account_code) {
         account_code.nonce = nextNonce;
       }); 
+      accountCode.nonce = nextNonce;
       return uint256_t(nextNonce);
     };
 
@@ -356,14 +354,23 @@ class eos_external: public External {
         endowment
       );
 
+      // lets a batch that drops this transaction remove the row again
+      pendingState->putContractCreate(codeAddressWord);
+
       eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
+      uint64_t pk = _account_code.available_primary_key();
+      uint64_t generation = _contract->nextGeneration(_sender);
       _account_code.emplace(_sender, [&](auto& account_code) {
-        account_code.pk = _account_code.available_primary_key();
+        account_code.pk = pk;
         account_code.owner = BigInt::toFixed32(ownerAddressWord);
         account_code.address = BigInt::toFixed32(codeAddressWord);
         account_code.nonce = 1;
+        account_code.codeHash = BigInt::toFixed32(EMPTY_CODE_HASH);
+        account_code.codeSize = 0;
         account_code.balance =  BigInt::toFixed32(0);
+        account_code.generation = generation;
       });
+      _cache->putCodeAccount(codeAddressWord, { true, pk, 1, uint256_t(0), EMPTY_CODE_HASH, 0, generation });
 
       return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
     }
@@ -373,13 +380,17 @@ class eos_external: public External {
       const uint256_t& endowment, 
       const bytes_t& code
     ) {
+      cached_code_account& accountCode = _cache->codeAccount(codeAddressWord);
+      if (!accountCode.exists) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
+      checksum256 codeHash = _contract->storeCode(_sender, code);
       eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
-      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
-      auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(codeAddressWord));
-      if (accountCodeItr == accountCodeIdx.end()) return std::make_pair(EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND, 0);
-      accountCodeIdx.modify(accountCodeItr, _sender, [&](auto& account_code) {
-        account_code.code = code;
+      _account_code.modify(_account_code.get(accountCode.pk), _sender, [&](auto& account_code) {
+        account_code.codeHash = codeHash;
+        account_code.codeSize = code.size();
       }); 
+      accountCode.codeHash = BigInt::fromFixed32(codeHash.extract_as_byte_array());
+      accountCode.codeSize = code.size();
+      _cache->putCode(accountCode.codeHash, code);
       return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
     }
 
@@ -403,15 +414,23 @@ class eos_external: public External {
 
       pendingState->putContractCreate(codeAddressWord);
 
+      checksum256 codeHash = _contract->storeCode(_sender, code);
       eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
+      uint64_t pk = _account_code.available_primary_key();
+      uint64_t generation = _contract->nextGeneration(_sender);
       _account_code.emplace(_sender, [&](auto& account_code) {
-        account_code.pk = _account_code.available_primary_key();
+        account_code.pk = pk;
         account_code.owner = BigInt::toFixed32(ownerAddressWord);
         account_code.address = BigInt::toFixed32(codeAddressWord);
         account_code.nonce = 1;
-        account_code.code = code;
+        account_code.codeHash = codeHash;
+        account_code.codeSize = code.size();
         account_code.balance = BigInt::toFixed32(0);
+        account_code.generation = generation;
       });
+      uint256_t codeHashWord = BigInt::fromFixed32(codeHash.extract_as_byte_array());
+      _cache->putCodeAccount(codeAddressWord, { true, pk, 1, uint256_t(0), codeHashWord, code.size(), generation });
+      _cache->putCode(codeHashWord, code);
 
       return std::make_pair(EmplaceResult::EMPLACE_SUCCESS, 0);
     }
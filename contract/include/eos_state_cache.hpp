@@ -0,0 +1,139 @@
+#pragma once
+#include <unordered_map>
+#include <eosio/eosio.hpp>
+#include <eos_evm.hpp>
+#include <evm/types.h>
+#include <evm/big_int.hpp>
+#include <evm/hash.hpp>
+#include <evm/pending_state.hpp>
+
+struct cached_code_account {
+  bool exists;
+  uint64_t pk;
+  uint64_t nonce;
+  uint256_t balance;
+  uint256_t codeHash;
+  uint64_t codeSize;
+  uint64_t generation;
+};
+
+struct cached_account {
+  bool exists;
+  uint256_t balance;
+};
+
+/*
+  Rows read by eos_external while a batch runs. Balances and storage are the persisted values;
+  pending changes stay in PendingState and are only written back when the batch commits, so the
+  rows here go stale only through eos_external's own nonce and code writes, which update the
+  cache too. Self-destructed contracts and reverted creations are erased at commit, so rawbatch
+  commits and starts a new cache after any transaction that leaves either behind.
+*/
+class eos_state_cache {
+  private:
+    eos_evm* _contract;
+    std::unordered_map<uint256_t, cached_code_account, WordHash> _codeAccounts;
+    std::unordered_map<uint256_t, cached_account, WordHash> _accounts;
+    std::unordered_map<slot_key_t, uint256_t, SlotKeyHash> _storage;
+    std::unordered_map<uint256_t, bytes_t, WordHash> _code;
+
+  public:
+    // lookups answered from the cache and lookups that went to a table, printed by execute
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    eos_state_cache(eos_evm* contract) {
+      _contract = contract;
+    }
+
+    cached_code_account& codeAccount(const uint256_t& address) {
+      auto found = _codeAccounts.find(address);
+      if (found != _codeAccounts.end()) {
+        hits++;
+        return found->second;
+      }
+
+      misses++;
+      cached_code_account row { false, 0, 0, uint256_t(0), uint256_t(0), 0, 0 };
+      eos_evm::account_code_table _account_code(_contract->get_self(), _contract->get_self().value);
+      auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
+      auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(address));
+      if (accountCodeItr != accountCodeIdx.end()) {
+        row.exists = true;
+        row.pk = accountCodeItr->pk;
+        row.nonce = accountCodeItr->nonce;
+        row.balance = BigInt::fromFixed32(accountCodeItr->balance.extract_as_byte_array());
+        row.codeHash = BigInt::fromFixed32(accountCodeItr->codeHash.extract_as_byte_array());
+        row.codeSize = accountCodeItr->codeSize;
+        row.generation = accountCodeItr->generation;
+      }
+      return _codeAccounts.emplace(address, row).first->second;
+    }
+
+    const cached_account& account(const uint256_t& address) {
+      auto found = _accounts.find(address);
+      if (found != _accounts.end()) {
+        hits++;
+        return found->second;
+      }
+
+      misses++;
+      cached_account row { false, uint256_t(0) };
+      eos_evm::account_table _account(_contract->get_self(), _contract->get_self().value);
+      auto accountIdx = _account.get_index<name("accountid")>();
+      auto accountItr = accountIdx.find(BigInt::toFixed32(address));
+      if (accountItr != accountIdx.end()) {
+        row.exists = true;
+        row.balance = BigInt::fromFixed32(accountItr->balance.extract_as_byte_array());
+      }
+      return _accounts.emplace(address, row).first->second;
+    }
+
+    uint256_t storageAt(const uint256_t& key, const uint256_t& codeAddress) {
+      slot_key_t slot { codeAddress, key };
+      auto found = _storage.find(slot);
+      if (found != _storage.end()) {
+        hits++;
+        return found->second;
+      }
+
+      misses++;
+      uint256_t value = uint256_t(0);
+      const cached_code_account& accountCode = codeAccount(codeAddress);
+      if (accountCode.exists) {
+        checksum256 compositeKey = BigInt::toFixed32(Hash::keccak256WordPair(codeAddress, key));
+        eos_evm::contract_state_table _contract_state(_contract->get_self(), eos_evm::stateScope(codeAddress));
+        uint64_t pk;
+        auto itr = eos_evm::findSlot(_contract_state, compositeKey, pk);
+        if (itr != _contract_state.end() && itr->generation == accountCode.generation) 
+          value = BigInt::fromFixed32(itr->value.extract_as_byte_array());
+      }
+      _storage.emplace(slot, value);
+      return value;
+    }
+
+    // code is shared by every account that deployed the same bytecode, so it is cached by hash
+    const bytes_t& code(const uint256_t& codeHash) {
+      auto found = _code.find(codeHash);
+      if (found != _code.end()) {
+        hits++;
+        return found->second;
+      }
+
+      misses++;
+      bytes_t code;
+      eos_evm::contract_code_table _contract_code(_contract->get_self(), _contract->get_self().value);
+      auto codeIdx = _contract_code.get_index<name("codehash")>();
+      auto codeItr = codeIdx.find(BigInt::toFixed32(codeHash));
+      if (codeItr != codeIdx.end()) code = codeItr->code;
+      return _code.emplace(codeHash, std::move(code)).first->second;
+    }
+
+    void putCodeAccount(const uint256_t& address, const cached_code_account& row) {
+      _codeAccounts[address] = row;
+    }
+
+    void putCode(const uint256_t& codeHash, const bytes_t& code) {
+      _code[codeHash] = code;
+    }
+};
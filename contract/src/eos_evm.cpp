@@ -1,5 +1,8 @@
 #include <string>
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <map>
 #include <eosio/crypto.hpp>
 
 #include <eos_evm.hpp>
@@ -19,174 +22,269 @@
 #include <evm/utils.hpp>
 
 void eos_evm::raw(name from, bytes_t code, string sender) {
-  incomingTransaction(from, code, sender, bytes_t());
+  require_auth(from);
+  transaction_batch batch = startBatch();
+  incomingTransaction(from, code, sender, bytes_t(), batch, "");
+  commitBatch(from, batch);
+}
+
+void eos_evm::rawbatch(name from, std::vector<bytes_t> txs) {
+  require_auth(from);
+  check(txs.size() > 0, "Please provide at least one transaction.");
+  transaction_batch batch = startBatch();
+  for (size_t i = 0; i < txs.size(); i++) {
+    incomingTransaction(from, txs[i], "", bytes_t(), batch, "[" + to_string(i) + "] ");
+    // removed contracts are only erased at commit, so later transactions must not see the cached rows
+    if (i + 1 < txs.size() && (batch.pendingState->selfDestruct.size() > 0 || batch.pendingState->revertedContractCreation.size() > 0)) {
+      commitBatch(from, batch);
+      batch = startBatch();
+    }
+  }
+  commitBatch(from, batch);
 }
 
 void eos_evm::execute(name from, bytes_t code, string sender, bytes_t bytecode) {
   #if RELEASE
   check(false, "execute is only available during development.");
   #endif
-  incomingTransaction(from, code, sender, bytecode);
-}
-
-void eos_evm::incomingTransaction(const name& from, const bytes_t& transaction, const string& sender, const bytes_t& bytecode) {
   require_auth(from);
+  transaction_batch batch = startBatch();
+  incomingTransaction(from, code, sender, bytecode, batch, "");
+  print("cache[hits=" + to_string(batch.cache->hits) + ", misses=" + to_string(batch.cache->misses) + "]");
+  commitBatch(from, batch);
+}
 
-  env_t env = eos_system::env();
-
-  rlp_list_t* rlp = new rlp_list_t();
-  RLPDecode::decode(transaction, rlp);
-
-  uint64_t transactionNonce = Overflow::uint256Cast(Transaction::nonce(rlp)).first;
-  bool hasSignature = Transaction::hasSignature(rlp);
-  bytes_t digest = Transaction::digest(rlp, 0x01);
-  bytes_t signature = Transaction::signature(rlp, env.chainId);
-
-  TransactionActionType actionType = Transaction::type(rlp);
-  gas_t gasLimit = Transaction::gas(rlp);
-  uint256_t gasPrice = Transaction::gasPrice(rlp);
-  uint256_t value = Transaction::value(rlp);
-  uint256_t toAddress = BigInt::fromBigEndianBytes(Transaction::address(rlp));
-  std::shared_ptr<bytes_t> data = std::make_shared<bytes_t>(Transaction::data(rlp));
+transaction_batch eos_evm::startBatch() {
+  // the interpreter only reads the new tables, so unmigrated rows would read as missing
+  legacy_account_code_table _legacy_account_code(get_self(), get_self().value);
+  account_state_table _account_state(get_self(), get_self().value);
+  check(_legacy_account_code.begin() == _legacy_account_code.end() && _account_state.begin() == _account_state.end(),
+    "Contract state is awaiting migration, run migratecode and then migratestate.");
+
+  return {
+    eos_system::env(),
+    std::shared_ptr<Operation>(),
+    std::shared_ptr<GasCalculation>(),
+    std::make_shared<PendingState>(),
+    std::make_shared<eos_state_cache>(this),
+    std::shared_ptr<External>(),
+    std::map<uint64_t, uint64_t>()
+  };
+}
 
-  bytes_t accountIdentifierBytes = hasSignature ? eos_ecrecover::recover(from.to_string(), rlp, env) : Hex::hexToBytes(sender);
+void eos_evm::incomingTransaction(
+  const name& from, 
+  const bytes_t& transaction, 
+  const string& sender, 
+  const bytes_t& bytecode, 
+  transaction_batch& batch, 
+  const string& label
+) {
+  const env_t& env = batch.env;
+
+  // cheapest checks first, so replayed or underfunded transactions fail before key recovery
+  transaction_view_t tx;
+  check(Transaction::parse(transaction, tx), label + "Invalid transaction encoding.");
+  check(tx.gas >= Transaction::intrinsicGas(tx), label + "Intrinsic gas exceeds the gas limit.");
+  std::pair<uint256_t, bool> upfrontCost = Transaction::upfrontCost(tx);
+  check(!upfrontCost.second, label + "Transaction value and gas cost overflow.");
+  check(tx.hasSignature || sender.size() > 0, label + "Unsigned transactions need a sender account identifier.");
+
+  bytes_t accountIdentifierBytes = sender.size() > 0 ? Hex::hexToBytes(sender) : eos_ecrecover::recover(from.to_string(), tx);
   checksum256 accountIdentifier = Hex::hexToChecksum256(accountIdentifierBytes);
   uint256_t senderAddress = BigInt::fromBigEndianBytes(accountIdentifierBytes);
 
-  delete rlp;
-
-  std::shared_ptr<Operation> operation = std::make_shared<Operation>();
-  std::shared_ptr<GasCalculation> gasCalculation = std::make_shared<GasCalculation>();
-  std::shared_ptr<PendingState> pendingState = std::make_shared<PendingState>();
-
   account_table _account(get_self(), get_self().value);
   auto idx = _account.get_index<name("accountid")>();
   auto itr = idx.find(accountIdentifier);
 
-  check(itr != idx.end(), hasSignature ? "The account identifier associated with this transaction does not exist." 
-    : "Could not find sender, did you provide the correct account identifier?");
-  check((transactionNonce - itr->nonce) == 1, "Transaction nonce invalid. got " + to_string(transactionNonce) + " wanted " + to_string(itr->nonce + 1));
-  if (!hasSignature) check(has_auth(itr->user), "You do not have permission to execute a transaction for the specified sender.");
+  check(itr != idx.end(), label + (sender.size() > 0 ? "Could not find sender, did you provide the correct account identifier?"
+    : "The account identifier associated with this transaction does not exist."));
+  // the account row is only written back when the batch commits
+  uint64_t& executed = batch.executed[itr->user.value];
+  uint64_t accountNonce = itr->nonce + executed;
+  uint64_t transactionNonce = Overflow::uint256Cast(tx.nonce).first;
+  check((transactionNonce - accountNonce) == 1, label + "Transaction nonce invalid. got " + to_string(transactionNonce) + " wanted " + to_string(accountNonce + 1));
+  uint256_t balance = batch.pendingState->balanceWithPendingChanges(senderAddress, BigInt::fromFixed32(itr->balance.extract_as_byte_array()));
+  check(balance >= upfrontCost.first, label + "Insufficient balance for value and gas.");
+
+  if (!tx.hasSignature) {
+    check(has_auth(itr->user), "You do not have permission to execute a transaction for the specified sender.");
+  } else if (sender.size() > 0) {
+    check(Hex::hexToChecksum256(eos_ecrecover::recover(from.to_string(), tx)) == accountIdentifier, 
+      label + "The transaction signature does not match the sender account identifier.");
+  }
 
   std::shared_ptr<External> external = std::make_shared<eos_external>(
-    this, senderAddress, itr->user, BigInt::fromFixed32(itr->balance.extract_as_byte_array()));
-
-  std::shared_ptr<Memory> memory = std::make_shared<Memory>();
+    this, senderAddress, itr->user, BigInt::fromFixed32(itr->balance.extract_as_byte_array()), batch.cache);
 
+  checkpoint_t checkpoint = batch.pendingState->checkpoint();
+  std::shared_ptr<Memory> memory;
   call_result_t callResult;
-  if (bytecode.size() > 0) {
-    callResult = Execute::code(
-      senderAddress, 
-      env, 
-      std::make_shared<bytes_t>(bytecode), 
-      actionType, 
-      gasLimit,
-      gasPrice,
-      value,
-      data,
-      toAddress,
-      operation,
-      gasCalculation,
-      external, 
-      pendingState
-    );
+  if (bytecode.size() == 0 && tx.type == TransactionActionType::TRANSACTION_CALL && Execute::isPlainTransfer(tx.to, *external, batch.pendingState)) {
+    // plain value transfer, nothing to run so the interpreter is never set up
+    callResult = Execute::transfer(senderAddress, tx.to, tx.value, tx.gas, external, batch.pendingState);
   } else {
-    callResult = Execute::transaction(
-      senderAddress, 
-      itr->nonce, 
-      env, 
-      actionType,
-      gasLimit,
-      gasPrice,
-      value,
-      data,
-      toAddress,
-      memory,
-      operation,
-      gasCalculation,
-      external, 
-      pendingState
-    );
+    if (!batch.operation) {
+      batch.operation = std::make_shared<Operation>();
+      batch.gasCalculation = std::make_shared<GasCalculation>();
+    }
+    memory = std::make_shared<Memory>();
+
+    if (bytecode.size() > 0) {
+      callResult = Execute::code(
+        senderAddress, 
+        env, 
+        std::make_shared<bytes_t>(bytecode), 
+        tx.type, 
+        tx.gas,
+        tx.gasPrice,
+        tx.value,
+        std::make_shared<bytes_t>(tx.data, tx.data + tx.dataSize),
+        tx.to,
+        batch.operation,
+        batch.gasCalculation,
+        external, 
+        batch.pendingState
+      );
+    } else {
+      callResult = Execute::transaction(
+        senderAddress, 
+        accountNonce, 
+        env, 
+        tx,
+        memory,
+        batch.operation,
+        batch.gasCalculation,
+        external, 
+        batch.pendingState
+      );
+
+      if (tx.type == TransactionActionType::TRANSACTION_CALL && callResult.first == MESSAGE_CALL_RETURN) {
+        MessageCallReturn messageCallReturn = std::get<MessageCallReturn>(callResult.second);
+        if (messageCallReturn.size > 0) 
+          print("return" + Hex::bytesToWordOutput(memory->memory, messageCallReturn.offset, messageCallReturn.size));
+      }
+    }
   }
 
-  checkCallResult(from, callResult, memory);
-  resolveAccountState(from, pendingState);
-  resolveLogs(pendingState, external);
+  string status = callResultStatus(callResult, memory);
+  bool failed = callResult.first != MESSAGE_CALL_SUCCESS && callResult.first != MESSAGE_CALL_RETURN;
+  if (label.size() == 0) {
+    check(!failed, status);
+  } else {
+    // a failed transaction in a batch keeps its nonce but none of its changes, and the batch carries on
+    if (failed) batch.pendingState->revert(checkpoint);
+    print(label + status + "\n");
+    resolveLogs(batch.pendingState, external, label);
+    batch.pendingState->logs.clear();
+  }
 
-  idx.modify(itr, from, [&](auto& account) {
-    account.nonce = itr->nonce + 1;
-    account.balance = BigInt::toFixed32(external->senderAccountBalance(pendingState));
-  });
+  executed += 1;
+  batch.external = external;
 }
 
-void eos_evm::checkCallResult(const name& from, call_result_t callResult, std::shared_ptr<Memory> memory) {
+void eos_evm::commitBatch(const name& from, transaction_batch& batch) {
+  resolveAccountState(from, batch.pendingState);
+  resolveLogs(batch.pendingState, batch.external, "");
+
+  account_table _account(get_self(), get_self().value);
+  for (const auto& account : batch.executed) {
+    auto itr = _account.find(account.first);
+    _account.modify(itr, from, [&](auto& account_row) {
+      account_row.nonce = itr->nonce + account.second;
+    });
+  }
+}
+
+string eos_evm::callResultStatus(call_result_t callResult, std::shared_ptr<Memory> memory) {
   switch (callResult.first) {
     case MESSAGE_CALL_SUCCESS:
+      return "MESSAGE_CALL_SUCCESS";
     case MESSAGE_CALL_RETURN:
-      break;
+      return "MESSAGE_CALL_RETURN";
     case MESSAGE_CALL_REVERTED:
       {
         MessageCallReturn messageCallReturn = std::get<MessageCallReturn>(callResult.second);
-        check(false, "MESSAGE_CALL_REVERTED" + Hex::bytesToWordOutput(memory->memory, messageCallReturn.offset, messageCallReturn.size));
-        break;
+        return "MESSAGE_CALL_REVERTED" + Hex::bytesToWordOutput(memory->memory, messageCallReturn.offset, messageCallReturn.size);
       }
     case MESSAGE_CALL_OUT_OF_GAS:
-      check(false, "MESSAGE_CALL_OUT_OF_GAS");
-      break;
+      return "MESSAGE_CALL_OUT_OF_GAS";
     case MESSAGE_CALL_FAILED:
       {
         trap_t trap = std::get<trap_t>(callResult.second);
         switch (trap) {
           case TrapKind::TRAP_STACK_UNDERFLOW:
-            check(false, "STACK_UNDERFLOW");
-            break;
+            return "STACK_UNDERFLOW";
           case TrapKind::TRAP_OUT_OF_STACK:
-            check(false, "STACK_LIMIT");
-            break;
+            return "STACK_LIMIT";
           case TrapKind::TRAP_INVALID_INSTRUCTION:
-            check(false, "INVALID_INSTRUCTION");
-            break;
+            return "INVALID_INSTRUCTION";
           case TrapKind::TRAP_INVALID_JUMP:
-            check(false, "JUMP_DESTINATION");
-            break;
+            return "JUMP_DESTINATION";
           case TrapKind::TRAP_INSUFFICIENT_FUNDS:
-            check(false, "MESSAGE_CALL_FAILED [Insufficient funds.]");
-            break;
+            return "MESSAGE_CALL_FAILED [Insufficient funds.]";
           case TrapKind::TRAP_INVALID_CODE_ADDRESS:
-            check(false, "MESSAGE_CALL_FAILED [An invalid address is attempting to modify a contract.]");
-            break;
+            return "MESSAGE_CALL_FAILED [An invalid address is attempting to modify a contract.]";
           case TrapKind::TRAP_OVERFLOW:
-            check(false, "MESSAGE_CALL_FAILED [An integer overflow ocurred.]");
-            break;
+            return "MESSAGE_CALL_FAILED [An integer overflow ocurred.]";
           case TrapKind::TRAP_MUTATE_STATIC:
-            check(false, "MESSAGE_CALL_FAILED [A mutation occurred in a static context.]");
-            break;
+            return "MESSAGE_CALL_FAILED [A mutation occurred in a static context.]";
+          case TrapKind::TRAP_PRECOMPILE_FAILED:
+            return "MESSAGE_CALL_FAILED [A precompiled contract rejected its input.]";
         }
         break;
       }
   }
+  return "MESSAGE_CALL_FAILED";
 }
 
 void eos_evm::resolveAccountState(const name& from, std::shared_ptr<PendingState> pendingState) {
   if (pendingState->accountState.size() > 0) {
-    account_state_table _account_state(get_self(), get_self().value);
-    for (int i = 0; i < pendingState->accountState.size(); i++) {
-      checksum256 compositeKey =  BigInt::toFixed32(Hash::keccak256WordPair(
-        pendingState->accountState.at(i).codeAddress,
-        pendingState->accountState.at(i).key
-      ));
-      auto idx = _account_state.get_index<name("statekey")>();
-      auto itr = idx.find(compositeKey);
-      if (itr != idx.end()) {
-        idx.modify(itr, from, [&](auto& account_state) {
-          account_state.value = BigInt::toFixed32(pendingState->accountState.at(i).value);
+    std::vector<account_state_t> resolved = pendingState->resolvedAccountState();
+    std::vector<std::pair<uint256_t, uint256_t>> slots;
+    slots.reserve(resolved.size());
+    for (const account_state_t& item : resolved) slots.push_back(std::make_pair(item.codeAddress, item.key));
+    std::vector<uint256_t> compositeKeys = Hash::keccak256WordPairs(slots);
+
+    std::vector<std::pair<checksum256, account_state_t>> writes;
+    writes.reserve(resolved.size());
+    for (size_t i = 0; i < resolved.size(); i++) {
+      writes.push_back(std::make_pair(BigInt::toFixed32(compositeKeys[i]), resolved[i]));
+    }
+    std::sort(writes.begin(), writes.end(), [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    });
+
+    std::map<uint256_t, uint64_t> generations;
+    for (const auto& write : writes) {
+      const checksum256& compositeKey = write.first;
+      const account_state_t& item = write.second;
+      checksum256 value = BigInt::toFixed32(item.value);
+      auto generation = generations.find(item.codeAddress);
+      if (generation == generations.end()) 
+        generation = generations.emplace(item.codeAddress, storageGeneration(item.codeAddress)).first;
+      // the contract no longer exists, anything written now would never be read
+      if (generation->second == 0) continue;
+
+      contract_state_table _contract_state(get_self(), stateScope(item.codeAddress));
+      uint64_t pk;
+      auto itr = findSlot(_contract_state, compositeKey, pk);
+      if (itr != _contract_state.end()) {
+        bool current = itr->generation == generation->second;
+        if (current ? itr->value == value : item.value == UINT256_ZERO) continue;
+        _contract_state.modify(itr, from, [&](auto& contract_state) {
+          contract_state.generation = generation->second;
+          contract_state.value = value;
         });
       } else {
-        _account_state.emplace(from, [&](auto& account_state) {
-          account_state.pk = _account_state.available_primary_key();
-          account_state.accountIdentifier = BigInt::toFixed32(pendingState->accountState.at(i).codeAddress);
-          account_state.key = compositeKey;
-          account_state.value = BigInt::toFixed32(pendingState->accountState.at(i).value);
+        // an absent slot already reads as zero
+        if (item.value == UINT256_ZERO) continue;
+        _contract_state.emplace(from, [&](auto& contract_state) {
+          contract_state.pk = pk;
+          contract_state.generation = generation->second;
+          contract_state.key = compositeKey;
+          contract_state.value = value;
         });
       }
     }
@@ -198,14 +296,15 @@ void eos_evm::resolveAccountState(const name& from, std::shared_ptr<PendingState
       auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
       auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(pendingState->revertedContractCreation[i].address));
       if (accountCodeItr != accountCodeIdx.end()) {
+        releaseCode(accountCodeItr->codeHash);
         accountCodeIdx.erase(accountCodeItr);
       }
     }
   }
 
-  std::set<resolved_balance_t> resolvedBalanceAddresses = pendingState->resolvedBalanceAddresses();
+  const std::vector<resolved_balance_t>& resolvedBalanceAddresses = pendingState->resolvedBalanceAddresses();
   if (resolvedBalanceAddresses.size() > 0) {
-    for (resolved_balance_t balanceAddress : resolvedBalanceAddresses) {
+    for (const resolved_balance_t& balanceAddress : resolvedBalanceAddresses) {
       if (balanceAddress.addressType == BalanceAddressType::BALANCE_ADDRESS_ACCOUNT) {
         eos_evm::account_table _account(get_self(), get_self().value);
         auto accountIdx = _account.get_index<name("accountid")>();
@@ -220,6 +319,7 @@ void eos_evm::resolveAccountState(const name& from, std::shared_ptr<PendingState
         eos_evm::account_code_table _account_code(get_self(), get_self().value);
         auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
         auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(balanceAddress.address));
+        if (accountCodeItr == accountCodeIdx.end()) continue;
         accountCodeIdx.modify(accountCodeItr, from, [&](auto& account_code) {
           account_code.balance = BigInt::toFixed32(pendingState->resolveAddressBalanceChanges(
             balanceAddress.address,  
@@ -236,22 +336,59 @@ void eos_evm::resolveAccountState(const name& from, std::shared_ptr<PendingState
       eos_evm::account_code_table _account_code(get_self(), get_self().value);
       auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
       auto accountCodeItr = accountCodeIdx.find(address);
+      // a contract can destroy itself more than once in a transaction
+      if (accountCodeItr == accountCodeIdx.end()) continue;
+      releaseCode(accountCodeItr->codeHash);
+      // the storage rows now match no generation, gcstate reclaims them later
       accountCodeIdx.erase(accountCodeItr);
-
-      eos_evm::account_state_table _account_state(get_self(), get_self().value);
-      auto accountStateIdx = _account_state.get_index<name("stateid")>();
-      auto accountStateItr = accountStateIdx.find(address);
-      while(accountStateItr != accountStateIdx.end()) {
-        accountStateItr = accountStateIdx.erase(accountStateItr);
-      }
     }
   }
 }
 
-void eos_evm::resolveLogs(std::shared_ptr<PendingState> pendingState, std::shared_ptr<External> external) {
+checksum256 eos_evm::storeCode(const name& payer, const bytes_t& code) {
+  checksum256 codeHash = BigInt::toFixed32(Hash::keccak256Word(code));
+  if (code.size() == 0) return codeHash;
+
+  contract_code_table _contract_code(get_self(), get_self().value);
+  auto codeIdx = _contract_code.get_index<name("codehash")>();
+  auto codeItr = codeIdx.find(codeHash);
+  if (codeItr != codeIdx.end()) {
+    codeIdx.modify(codeItr, same_payer, [&](auto& contract_code) {
+      contract_code.references += 1;
+    });
+    return codeHash;
+  }
+
+  _contract_code.emplace(payer, [&](auto& contract_code) {
+    contract_code.pk = _contract_code.available_primary_key();
+    contract_code.codeHash = codeHash;
+    contract_code.codeSize = code.size();
+    contract_code.references = 1;
+    contract_code.code = code;
+  });
+  return codeHash;
+}
+
+void eos_evm::releaseCode(const checksum256& codeHash) {
+  contract_code_table _contract_code(get_self(), get_self().value);
+  auto codeIdx = _contract_code.get_index<name("codehash")>();
+  auto codeItr = codeIdx.find(codeHash);
+  if (codeItr == codeIdx.end()) return;
+  if (codeItr->references <= 1) {
+    codeIdx.erase(codeItr);
+    return;
+  }
+  codeIdx.modify(codeItr, same_payer, [&](auto& contract_code) {
+    contract_code.references -= 1;
+  });
+}
+
+void eos_evm::resolveLogs(std::shared_ptr<PendingState> pendingState, std::shared_ptr<External> external, const string& label) {
   if (pendingState->logs.size() > 0) {
     for (int i = 0; i < pendingState->logs.size(); i++) {
+      if (label.size() > 0) print(label);
       external->log(pendingState->logs.at(i).topics, pendingState->logs.at(i).data);
+      if (label.size() > 0) print("\n");
     }
   }
 }
@@ -302,6 +439,109 @@ void eos_evm::withdraw(name to, asset quantity) {
   }.send();
 }
 
+void eos_evm::migratecode(uint64_t limit) {
+  require_auth(get_self());
+
+  legacy_account_code_table _legacy_account_code(get_self(), get_self().value);
+  account_code_table _account_code(get_self(), get_self().value);
+  auto itr = _legacy_account_code.begin();
+  for (uint64_t i = 0; i < limit && itr != _legacy_account_code.end(); i++) {
+    checksum256 codeHash = storeCode(get_self(), itr->code);
+    uint64_t generation = nextGeneration(get_self());
+    _account_code.emplace(get_self(), [&](auto& account_code) {
+      account_code.pk = _account_code.available_primary_key();
+      account_code.owner = itr->owner;
+      account_code.address = itr->address;
+      account_code.nonce = itr->nonce;
+      account_code.codeHash = codeHash;
+      account_code.codeSize = itr->code.size();
+      account_code.balance = itr->balance;
+      account_code.generation = generation;
+    });
+    itr = _legacy_account_code.erase(itr);
+  }
+}
+
+void eos_evm::migratestate(uint64_t limit) {
+  require_auth(get_self());
+
+  // storage is copied under the contract's generation, which only exists once its code row has moved
+  legacy_account_code_table _legacy_account_code(get_self(), get_self().value);
+  check(_legacy_account_code.begin() == _legacy_account_code.end(), "Run migratecode until the legacy account code table is empty first.");
+
+  account_state_table _account_state(get_self(), get_self().value);
+  auto itr = _account_state.begin();
+  for (uint64_t i = 0; i < limit && itr != _account_state.end(); i++) {
+    uint256_t codeAddress = BigInt::fromFixed32(itr->accountIdentifier.extract_as_byte_array());
+    uint64_t generation = storageGeneration(codeAddress);
+    contract_state_table _contract_state(get_self(), stateScope(codeAddress));
+    uint64_t pk;
+    if (generation != 0 && findSlot(_contract_state, itr->key, pk) == _contract_state.end()) {
+      _contract_state.emplace(get_self(), [&](auto& contract_state) {
+        contract_state.pk = pk;
+        contract_state.generation = generation;
+        contract_state.key = itr->key;
+        contract_state.value = itr->value;
+      });
+    }
+    itr = _account_state.erase(itr);
+  }
+}
+
+void eos_evm::gcstate(uint64_t scope, uint64_t start, uint64_t limit) {
+  account_code_table _account_code(get_self(), get_self().value);
+  auto generationIdx = _account_code.get_index<name("generation")>();
+  std::map<uint64_t, bool> live;
+  contract_state_table _contract_state(get_self(), scope);
+  auto itr = _contract_state.lower_bound(start);
+  for (uint64_t i = 0; i < limit && itr != _contract_state.end(); i++) {
+    // a row is live while some contract still holds its generation
+    auto found = live.find(itr->generation);
+    if (found == live.end()) 
+      found = live.emplace(itr->generation, generationIdx.find(itr->generation) != generationIdx.end()).first;
+    if (found->second) {
+      itr++;
+      continue;
+    }
+
+    // keep rows a displaced slot further along has to probe past
+    bool bridgesProbe = false;
+    for (auto next = _contract_state.find(itr->pk + 1); next != _contract_state.end(); next = _contract_state.find(next->pk + 1)) {
+      if (slotPrimaryKey(next->key) <= itr->pk) {
+        bridgesProbe = true;
+        break;
+      }
+    }
+    itr = bridgesProbe ? std::next(itr) : _contract_state.erase(itr);
+  }
+  print(itr == _contract_state.end() ? "done" : "next " + to_string(itr->pk));
+}
+
+uint64_t eos_evm::nextGeneration(const name& payer) {
+  storage_generation_table _storage_generation(get_self(), get_self().value);
+  auto itr = _storage_generation.find(0);
+  if (itr == _storage_generation.end()) {
+    _storage_generation.emplace(payer, [&](auto& storage_generation) {
+      storage_generation.pk = 0;
+      storage_generation.next = 2;
+    });
+    return 1;
+  }
+  uint64_t generation = itr->next;
+  _storage_generation.modify(itr, same_payer, [&](auto& storage_generation) {
+    storage_generation.next = generation + 1;
+  });
+  return generation;
+}
+
+// the generation of the contract at codeAddress, or 0 when there is no contract there
+uint64_t eos_evm::storageGeneration(const uint256_t& codeAddress) const {
+  account_code_table _account_code(get_self(), get_self().value);
+  auto accountCodeIdx = _account_code.get_index<name("codeaddress")>();
+  auto accountCodeItr = accountCodeIdx.find(BigInt::toFixed32(codeAddress));
+  return accountCodeItr == accountCodeIdx.end() ? 0 : accountCodeItr->generation;
+}
+
 void eos_evm::transfer(name from, name to, asset quantity, string memo) {
   if (from == get_self()) return;
   if (to != get_self()) return;
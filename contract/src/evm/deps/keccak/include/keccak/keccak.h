@@ -32,6 +32,20 @@ extern "C" {
 
   union ethash_hash256 ethash_keccak256(const uint8_t* data, size_t size);
   union ethash_hash256 ethash_keccak256_32(const uint8_t data[32]);
+
+  /**
+  * Keccak-256 of count independent inputs.
+  *
+  * Inputs shorter than one 136 byte block are hashed four at a time, one per lane of a
+  * vectorised Keccak-f[1600] where the CPU supports it; longer ones are hashed one by one.
+  *
+  * @param out    The count hashes, in the order of the inputs.
+  * @param data   The inputs.
+  * @param sizes  The size of each input in bytes.
+  * @param count  The number of inputs.
+  */
+  void ethash_keccak256_batch(
+      union ethash_hash256* out, const uint8_t* const* data, const size_t* sizes, size_t count);
   union ethash_hash512 ethash_keccak512(const uint8_t* data, size_t size);
   union ethash_hash512 ethash_keccak512_64(const uint8_t data[64]);
 
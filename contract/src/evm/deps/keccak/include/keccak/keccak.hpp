@@ -19,6 +19,12 @@ namespace ethash
     return ethash_keccak256_32(input.bytes);
   }
 
+  inline void keccak256_batch(
+      hash256* out, const uint8_t* const* data, const size_t* sizes, size_t count) noexcept
+  {
+    ethash_keccak256_batch(out, data, sizes, count);
+  }
+
   inline hash512 keccak512(const uint8_t* data, size_t size) noexcept
   {
     return ethash_keccak512(data, size);
@@ -3,4 +3,6 @@ class Keccakf1600 {
     static uint64_t rol(uint64_t x, unsigned s);
     static const uint64_t round_constants[24];
     static void keccakf1600(uint64_t state[25]);
+    // four independent states side by side, word i of lane j at state[i][j]
+    static void keccakf1600x4(uint64_t state[25][4]);
 };
\ No newline at end of file
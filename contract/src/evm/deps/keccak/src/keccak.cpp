@@ -95,6 +95,72 @@ union ethash_hash256 ethash_keccak256_32(const uint8_t data[32])
     return hash;
 }
 
+/** Pads an input shorter than one block into lane `lane` of four interleaved states. */
+static void absorb_short(uint64_t state[25][4], size_t lane, const uint8_t* data, size_t size)
+{
+    uint8_t block[136] = {0};
+    size_t i;
+
+    if (size > 0)
+        __builtin_memcpy(block, data, size);
+    block[size] ^= 0x01;
+    block[sizeof(block) - 1] ^= 0x80;
+
+    for (i = 0; i < 25; ++i)
+        state[i][lane] = i < sizeof(block) / sizeof(uint64_t) ? load_le(block + i * sizeof(uint64_t)) : 0;
+}
+
+/** Hashes the inputs at indexes[0..n), each shorter than one block, with a single permutation. */
+static void keccak256_lanes(union ethash_hash256* out, const uint8_t* const* data, const size_t* sizes,
+    const size_t* indexes, size_t n)
+{
+    uint64_t state[25][4] = {{0}};
+    size_t i, j;
+
+    if (n == 1)
+    {
+        keccak(out[indexes[0]].word64s, 256, data[indexes[0]], sizes[indexes[0]]);
+        return;
+    }
+
+    for (j = 0; j < n; ++j)
+        absorb_short(state, j, data[indexes[j]], sizes[indexes[j]]);
+
+    Keccakf1600::keccakf1600x4(state);
+
+    for (j = 0; j < n; ++j)
+        for (i = 0; i < 4; ++i)
+            out[indexes[j]].word64s[i] = state[i][j];
+}
+
+void ethash_keccak256_batch(
+    union ethash_hash256* out, const uint8_t* const* data, const size_t* sizes, size_t count)
+{
+    static const size_t block_size = (1600 - 256 * 2) / 8;
+    size_t indexes[4];
+    size_t n = 0;
+    size_t i;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (sizes[i] >= block_size)
+        {
+            keccak(out[i].word64s, 256, data[i], sizes[i]);
+            continue;
+        }
+
+        indexes[n++] = i;
+        if (n == 4)
+        {
+            keccak256_lanes(out, data, sizes, indexes, n);
+            n = 0;
+        }
+    }
+
+    if (n > 0)
+        keccak256_lanes(out, data, sizes, indexes, n);
+}
+
 union ethash_hash512 ethash_keccak512(const uint8_t* data, size_t size)
 {
     union ethash_hash512 hash;
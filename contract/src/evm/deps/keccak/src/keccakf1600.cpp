@@ -6,6 +6,11 @@
 #include <stdint.h>
 #include <keccak/keccakf1600.h>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KECCAKF1600_AVX2
+#include <immintrin.h>
+#endif
+
 uint64_t Keccakf1600::rol(uint64_t x, unsigned s)
 {
   return (x << s) | (x >> (64 - s));
@@ -253,4 +258,105 @@ void Keccakf1600::keccakf1600(uint64_t state[25])
     state[22] = Asi;
     state[23] = Aso;
     state[24] = Asu;
-}
\ No newline at end of file
+}
+
+/* Rotation offsets and lane order of the combined rho and pi steps, walking the lanes from (1, 0). */
+static const unsigned rho_offsets[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+static const unsigned pi_lanes[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+#if defined(KECCAKF1600_AVX2)
+__attribute__((target("avx2")))
+static inline __m256i rol4(__m256i x, unsigned s)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(x, s), _mm256_srli_epi64(x, 64 - s));
+}
+
+/* One 64-bit lane of each of the four states per register, so every step is the scalar one.
+   The loops inside a round are unrolled so the table lookups fold away and A stays in registers. */
+__attribute__((target("avx2")))
+static void keccakf1600x4_avx2(uint64_t state[25][4])
+{
+    __m256i A[25];
+    __m256i C[5];
+    __m256i D;
+    __m256i row[5];
+    __m256i t;
+    __m256i previous;
+    int round, x, y, i;
+
+    for (i = 0; i < 25; ++i)
+        A[i] = _mm256_loadu_si256((const __m256i*)state[i]);
+
+    for (round = 0; round < 24; ++round)
+    {
+        /* Theta */
+        #pragma GCC unroll 25
+        for (x = 0; x < 5; ++x)
+            C[x] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(A[x], A[x + 5]),
+                _mm256_xor_si256(A[x + 10], A[x + 15])), A[x + 20]);
+        #pragma GCC unroll 25
+        for (x = 0; x < 5; ++x)
+        {
+            D = _mm256_xor_si256(C[(x + 4) % 5], rol4(C[(x + 1) % 5], 1));
+            #pragma GCC unroll 25
+            for (y = 0; y < 25; y += 5)
+                A[y + x] = _mm256_xor_si256(A[y + x], D);
+        }
+
+        /* Rho and pi */
+        previous = A[1];
+        #pragma GCC unroll 25
+        for (i = 0; i < 24; ++i)
+        {
+            t = A[pi_lanes[i]];
+            A[pi_lanes[i]] = rol4(previous, rho_offsets[i]);
+            previous = t;
+        }
+
+        /* Chi */
+        #pragma GCC unroll 25
+        for (y = 0; y < 25; y += 5)
+        {
+            #pragma GCC unroll 25
+            for (x = 0; x < 5; ++x)
+                row[x] = A[y + x];
+            #pragma GCC unroll 25
+            for (x = 0; x < 5; ++x)
+                A[y + x] = _mm256_xor_si256(row[x], _mm256_andnot_si256(row[(x + 1) % 5], row[(x + 2) % 5]));
+        }
+
+        /* Iota */
+        A[0] = _mm256_xor_si256(A[0], _mm256_set1_epi64x((long long)Keccakf1600::round_constants[round]));
+    }
+
+    for (i = 0; i < 25; ++i)
+        _mm256_storeu_si256((__m256i*)state[i], A[i]);
+}
+#endif
+
+void Keccakf1600::keccakf1600x4(uint64_t state[25][4])
+{
+#if defined(KECCAKF1600_AVX2)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2)
+    {
+        keccakf1600x4_avx2(state);
+        return;
+    }
+#endif
+
+    uint64_t lane[25];
+    int i, j;
+    for (j = 0; j < 4; ++j)
+    {
+        #pragma GCC unroll 25
+        for (i = 0; i < 25; ++i)
+            lane[i] = state[i][j];
+        keccakf1600(lane);
+        #pragma GCC unroll 25
+        for (i = 0; i < 25; ++i)
+            state[i][j] = lane[i];
+    }
+}
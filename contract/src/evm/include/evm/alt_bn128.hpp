@@ -0,0 +1,292 @@
+#pragma once
+#include <vector>
+#include <evm/types.h>
+#include <evm/big_int.hpp>
+#include <evm/alt_bn128_field.hpp>
+
+// an affine point, or the point at infinity
+template <typename Field>
+struct Bn128Affine {
+  Field x;
+  Field y;
+  bool infinity;
+};
+
+/*
+  Points of y^2 = x^3 + b in Jacobian coordinates (x / z^2, y / z^3), over Fp for G1 and over
+  Fp2 for the G2 twist.
+*/
+template <typename Field>
+class Bn128Point {
+  public:
+    Field x;
+    Field y;
+    Field z;
+    bool infinity;
+
+    static Bn128Point atInfinity() {
+      return Bn128Point { Field(), Field(), Field(), true };
+    }
+
+    static Bn128Point fromAffine(const Bn128Affine<Field>& point) {
+      if (point.infinity) return atInfinity();
+      return Bn128Point { point.x, point.y, Field::one(), false };
+    }
+
+    Bn128Affine<Field> affine() const {
+      if (infinity) return Bn128Affine<Field> { Field(), Field(), true };
+      Field zInverse = z.inverse();
+      Field zInverse2 = zInverse.square();
+      return Bn128Affine<Field> { x * zInverse2, y * zInverse2 * zInverse, false };
+    }
+
+    Bn128Point doublePoint() const {
+      if (infinity || y.isZero()) return atInfinity();
+      Field a = x.square();
+      Field b = y.square();
+      Field c = b.square();
+      Field d = (x + b).square() - a - c;
+      d = d + d;
+      Field e = a + a + a;
+      Field xOut = e.square() - d - d;
+      Field c8 = c + c;
+      c8 = c8 + c8;
+      c8 = c8 + c8;
+      Field yz = y * z;
+      return Bn128Point { xOut, e * (d - xOut) - c8, yz + yz, false };
+    }
+
+    Bn128Point operator+(const Bn128Point& other) const {
+      if (infinity) return other;
+      if (other.infinity) return *this;
+
+      Field z1z1 = z.square();
+      Field z2z2 = other.z.square();
+      Field u1 = x * z2z2;
+      Field u2 = other.x * z1z1;
+      Field s1 = y * z2z2 * other.z;
+      Field s2 = other.y * z1z1 * z;
+      Field h = u2 - u1;
+      Field r = s2 - s1;
+
+      if (h.isZero()) {
+        if (r.isZero()) return doublePoint();
+        return atInfinity();
+      }
+
+      Field h2 = h.square();
+      Field h3 = h2 * h;
+      Field u1h2 = u1 * h2;
+      Field xOut = r.square() - h3 - u1h2 - u1h2;
+      return Bn128Point { xOut, r * (u1h2 - xOut) - s1 * h3, z * other.z * h, false };
+    }
+
+    Bn128Point multiply(const uint256_t& scalar) const {
+      Bn128Point result = atInfinity();
+      for (size_t i = 256; i > 0; i--) {
+        result = result.doublePoint();
+        if (((scalar >> (i - 1)) & 1) != 0) result = result + *this;
+      }
+      return result;
+    }
+};
+
+typedef Bn128Affine<Bn128Field> bn128_g1_t;
+typedef Bn128Affine<Bn128Field2> bn128_g2_t;
+
+/*
+  The alt_bn128 precompiles: G1 addition, G1 scalar multiplication and the optimal ate pairing
+  check. Coordinates are big-endian words, and an Fp2 element is written imaginary part first.
+  Each returns false on input that is not a valid point, which fails the call.
+*/
+class AltBn128 {
+  public:
+    static constexpr uint256_t ORDER = intx::from_string<uint256_t>("0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001");
+    // the BN parameter x, and 6x + 2 - 2^64 for the Miller loop below its top bit
+    static constexpr uint64_t X = 4965661367192848881;
+    static constexpr uint64_t ATE_LOOP = 0x9d797039be763ba8;
+
+    static bool add(const bytes_t& input, bytes_t& output) {
+      bytes_t data = padded(input, 128);
+      bn128_g1_t a, b;
+      if (!readG1(data.data(), a) || !readG1(data.data() + 64, b)) return false;
+      output = writeG1((Bn128Point<Bn128Field>::fromAffine(a) + Bn128Point<Bn128Field>::fromAffine(b)).affine());
+      return true;
+    }
+
+    static bool multiply(const bytes_t& input, bytes_t& output) {
+      bytes_t data = padded(input, 96);
+      bn128_g1_t point;
+      if (!readG1(data.data(), point)) return false;
+      uint256_t scalar = BigInt::fromBigEndianBytes(data.data() + 64, WORD_SIZE);
+      output = writeG1(Bn128Point<Bn128Field>::fromAffine(point).multiply(scalar).affine());
+      return true;
+    }
+
+    // a word that is 1 when the product of the pairings of each (G1, G2) pair is one
+    static bool pairing(const bytes_t& input, bytes_t& output) {
+      if (input.size() % 192 != 0) return false;
+
+      std::vector<bn128_g1_t> g1;
+      std::vector<bn128_g2_t> g2;
+      for (size_t offset = 0; offset < input.size(); offset += 192) {
+        bn128_g1_t p;
+        bn128_g2_t q;
+        if (!readG1(input.data() + offset, p) || !readG2(input.data() + offset + 64, q)) return false;
+        // a pair with a point at infinity contributes one
+        if (p.infinity || q.infinity) continue;
+        g1.push_back(p);
+        g2.push_back(q);
+      }
+
+      bool isOne = g1.empty() || finalExponentiation(millerLoop(g1, g2)) == Bn128Field12::one();
+      output = BigInt::toBytes(isOne ? 1 : 0);
+      return true;
+    }
+
+    /*
+      The product over all pairs of f_{6x+2,Q}(P) l_{T,pi(Q)}(P) l_{T',-pi^2(Q)}(P), sharing the
+      squarings of the accumulator between pairs. T walks in Jacobian coordinates on the twist
+      so no step inverts, and each line is evaluated at P through the untwisting map
+      (x, y) -> (x w^2, y w^3). Lines are scaled by factors in Fp2, which the final
+      exponentiation removes.
+    */
+    static Bn128Field12 millerLoop(const std::vector<bn128_g1_t>& g1, const std::vector<bn128_g2_t>& g2) {
+      std::vector<Bn128Point<Bn128Field2>> t;
+      for (const bn128_g2_t& q : g2) t.push_back(Bn128Point<Bn128Field2>::fromAffine(q));
+      Bn128Field12 f = Bn128Field12::one();
+
+      for (size_t i = 64; i > 0; i--) {
+        f = f.square();
+        bool bit = ((ATE_LOOP >> (i - 1)) & 1) != 0;
+        for (size_t k = 0; k < g1.size(); k++) {
+          f = doubleStep(f, t[k], g1[k]);
+          if (bit) f = addStep(f, t[k], g2[k], g1[k]);
+        }
+      }
+
+      for (size_t k = 0; k < g1.size(); k++) {
+        bn128_g2_t q1 = twistFrobenius(g2[k]);
+        bn128_g2_t q2 = twistFrobenius(q1);
+        q2.y = q2.y.negate();
+        f = addStep(f, t[k], q1, g1[k]);
+        f = addStep(f, t[k], q2, g1[k]);
+      }
+      return f;
+    }
+
+    // f^((p^12 - 1) / r); the hard part (p^4 - p^2 + 1) / r is written in powers of x and p
+    static Bn128Field12 finalExponentiation(const Bn128Field12& f) {
+      Bn128Field12 t1 = f.conjugate() * f.inverse();
+      t1 = t1.frobenius().frobenius() * t1;
+
+      Bn128Field12 fp = t1.frobenius();
+      Bn128Field12 fp2 = fp.frobenius();
+      Bn128Field12 fp3 = fp2.frobenius();
+      Bn128Field12 fu = t1.power(X);
+      Bn128Field12 fu2 = fu.power(X);
+      Bn128Field12 fu3 = fu2.power(X);
+
+      Bn128Field12 y0 = fp * fp2 * fp3;
+      Bn128Field12 y1 = t1.conjugate();
+      Bn128Field12 y2 = fu2.frobenius().frobenius();
+      Bn128Field12 y3 = fu.frobenius().conjugate();
+      Bn128Field12 y4 = (fu * fu2.frobenius()).conjugate();
+      Bn128Field12 y5 = fu2.conjugate();
+      Bn128Field12 y6 = (fu3 * fu3.frobenius()).conjugate();
+
+      Bn128Field12 t0 = y6.square() * y4 * y5;
+      t1 = y3 * y5 * t0;
+      t0 = t0 * y2;
+      t1 = (t1.square() * t0).square();
+      t0 = t1 * y1;
+      t1 = t1 * y0;
+      return t0.square() * t1;
+    }
+
+  private:
+    static bytes_t padded(const bytes_t& input, size_t size) {
+      bytes_t data(size, 0);
+      std::copy(input.begin(), input.begin() + std::min(input.size(), size), data.begin());
+      return data;
+    }
+
+    static bool readField(const uint8_t* data, Bn128Field& element) {
+      uint256_t word = BigInt::fromBigEndianBytes(data, WORD_SIZE);
+      if (word >= Bn128Field::MODULUS) return false;
+      element = Bn128Field(word);
+      return true;
+    }
+
+    // (0, 0) is the point at infinity
+    static bool readG1(const uint8_t* data, bn128_g1_t& point) {
+      if (!readField(data, point.x) || !readField(data + 32, point.y)) return false;
+      point.infinity = point.x.isZero() && point.y.isZero();
+      if (point.infinity) return true;
+      return point.y.square() == point.x.square() * point.x + Bn128Field(3);
+    }
+
+    // on the twist y^2 = x^3 + 3 / (9 + i), and in the order r subgroup, which the twist does not fill
+    static bool readG2(const uint8_t* data, bn128_g2_t& point) {
+      Bn128Field xImaginary, xReal, yImaginary, yReal;
+      if (!readField(data, xImaginary) || !readField(data + 32, xReal)) return false;
+      if (!readField(data + 64, yImaginary) || !readField(data + 96, yReal)) return false;
+      point.x = Bn128Field2(xReal, xImaginary);
+      point.y = Bn128Field2(yReal, yImaginary);
+      point.infinity = point.x.isZero() && point.y.isZero();
+      if (point.infinity) return true;
+
+      static const Bn128Field2 b = Bn128Field2(Bn128Field(3), Bn128Field()) * Bn128Field2::xi().inverse();
+      if (!(point.y.square() == point.x.square() * point.x + b)) return false;
+      return Bn128Point<Bn128Field2>::fromAffine(point).multiply(ORDER).infinity;
+    }
+
+    static bytes_t writeG1(const bn128_g1_t& point) {
+      bytes_t output = BigInt::toBytes(point.infinity ? uint256_t(0) : point.x.word());
+      bytes_t y = BigInt::toBytes(point.infinity ? uint256_t(0) : point.y.word());
+      output.insert(output.end(), y.begin(), y.end());
+      return output;
+    }
+
+    /*
+      f times the tangent at t evaluated at p, doubling t. With slope 3X^2 / 2YZ the line
+      y_p - slope x_p w + (slope x - y) w^3 is scaled by 2YZ^3.
+    */
+    static Bn128Field12 doubleStep(const Bn128Field12& f, Bn128Point<Bn128Field2>& t, const bn128_g1_t& p) {
+      Bn128Field2 xx = t.x.square();
+      Bn128Field2 yy = t.y.square();
+      Bn128Field2 zz = t.z.square();
+      Bn128Field2 xx3 = xx + xx + xx;
+      Bn128Field2 l3 = xx3 * t.x - yy - yy;
+      Bn128Field2 l1 = (xx3 * zz * p.x).negate();
+
+      t = t.doublePoint();
+      return f.mulByLine(t.z * zz * p.y, l1, l3);
+    }
+
+    /*
+      f times the line through t and the affine q evaluated at p, adding q to t. With slope
+      R / ZH, where H = x_q Z^2 - X and R = y_q Z^3 - Y, the line written through q is scaled
+      by ZH.
+    */
+    static Bn128Field12 addStep(const Bn128Field12& f, Bn128Point<Bn128Field2>& t, const bn128_g2_t& q, const bn128_g1_t& p) {
+      Bn128Field2 zz = t.z.square();
+      Bn128Field2 h = q.x * zz - t.x;
+      Bn128Field2 r = q.y * zz * t.z - t.y;
+      Bn128Field2 zh = t.z * h;
+
+      Bn128Field2 hh = h.square();
+      Bn128Field2 hhh = hh * h;
+      Bn128Field2 v = t.x * hh;
+      Bn128Field2 x = r.square() - hhh - v - v;
+      t = Bn128Point<Bn128Field2> { x, r * (v - x) - t.y * hhh, zh, false };
+
+      return f.mulByLine(zh * p.y, (r * p.x).negate(), r * q.x - q.y * zh);
+    }
+
+    // the p-power Frobenius carried back to the twist
+    static bn128_g2_t twistFrobenius(const bn128_g2_t& q) {
+      const std::array<Bn128Field2, 6>& gamma = Bn128Field12::frobeniusCoefficients();
+      return bn128_g2_t { q.x.conjugate() * gamma[2], q.y.conjugate() * gamma[3], false };
+    }
+};
@@ -0,0 +1,397 @@
+#pragma once
+#include <array>
+#include <evm/types.h>
+
+/*
+  An element of the alt_bn128 (BN254) base field, held in Montgomery form (x 2^256 mod p) in
+  four little-endian 64-bit limbs so a product reduces without dividing.
+*/
+class Bn128Field {
+  public:
+    static constexpr uint256_t MODULUS = intx::from_string<uint256_t>("0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47");
+
+    Bn128Field(): limbs { 0, 0, 0, 0 } {};
+
+    // for value < p
+    explicit Bn128Field(const uint256_t& value) {
+      Bn128Field plain;
+      for (size_t i = 0; i < 4; i++) plain.limbs[i] = static_cast<uint64_t>(value >> (64 * i));
+      *this = plain * fromLimbs(R2);
+    }
+
+    static Bn128Field one() {
+      return fromLimbs(R);
+    }
+
+    uint256_t word() const {
+      Bn128Field unit;
+      unit.limbs[0] = 1;
+      Bn128Field plain = *this * unit;
+      uint256_t value = 0;
+      for (size_t i = 4; i > 0; i--) value = (value << 64) | plain.limbs[i - 1];
+      return value;
+    }
+
+    bool isZero() const {
+      return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) == 0;
+    }
+
+    bool operator==(const Bn128Field& other) const {
+      return limbs[0] == other.limbs[0] && limbs[1] == other.limbs[1]
+        && limbs[2] == other.limbs[2] && limbs[3] == other.limbs[3];
+    }
+
+    Bn128Field operator+(const Bn128Field& other) const {
+      Bn128Field result;
+      uint64_t carry = 0;
+      for (size_t i = 0; i < 4; i++) {
+        intx::uint128 sum = intx::uint128(limbs[i]) + other.limbs[i] + carry;
+        result.limbs[i] = sum.lo;
+        carry = sum.hi;
+      }
+      result.reduce(carry);
+      return result;
+    }
+
+    Bn128Field operator-(const Bn128Field& other) const {
+      Bn128Field result;
+      uint64_t borrow = 0;
+      for (size_t i = 0; i < 4; i++) {
+        intx::uint128 difference = intx::uint128(limbs[i]) - other.limbs[i] - borrow;
+        result.limbs[i] = difference.lo;
+        borrow = difference.hi != 0 ? 1 : 0;
+      }
+      if (borrow != 0) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < 4; i++) {
+          intx::uint128 sum = intx::uint128(result.limbs[i]) + P[i] + carry;
+          result.limbs[i] = sum.lo;
+          carry = sum.hi;
+        }
+      }
+      return result;
+    }
+
+    Bn128Field negate() const {
+      return Bn128Field() - *this;
+    }
+
+    // x y / 2^256 mod p, interleaving the multiplication and the reduction (CIOS)
+    Bn128Field operator*(const Bn128Field& other) const {
+      uint64_t t[6] = { 0, 0, 0, 0, 0, 0 };
+      for (size_t i = 0; i < 4; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < 4; j++) {
+          intx::uint128 sum = intx::umul(limbs[j], other.limbs[i]) + t[j] + carry;
+          t[j] = sum.lo;
+          carry = sum.hi;
+        }
+        intx::uint128 top = intx::uint128(t[4]) + carry;
+        t[4] = top.lo;
+        t[5] = top.hi;
+
+        uint64_t u = t[0] * P_INVERSE;
+        intx::uint128 sum = intx::umul(u, P[0]) + t[0];
+        carry = sum.hi;
+        for (size_t j = 1; j < 4; j++) {
+          sum = intx::umul(u, P[j]) + t[j] + carry;
+          t[j - 1] = sum.lo;
+          carry = sum.hi;
+        }
+        top = intx::uint128(t[4]) + carry;
+        t[3] = top.lo;
+        t[4] = t[5] + top.hi;
+      }
+
+      Bn128Field result;
+      for (size_t i = 0; i < 4; i++) result.limbs[i] = t[i];
+      result.reduce(t[4]);
+      return result;
+    }
+
+    Bn128Field square() const {
+      return *this * *this;
+    }
+
+    // this^(p - 2), for a non-zero element
+    Bn128Field inverse() const {
+      return power(MODULUS - 2);
+    }
+
+    Bn128Field power(const uint256_t& exponent) const {
+      Bn128Field result = one();
+      for (size_t i = 256; i > 0; i--) {
+        result = result.square();
+        if (((exponent >> (i - 1)) & 1) != 0) result = result * *this;
+      }
+      return result;
+    }
+
+  private:
+    static constexpr uint64_t P[4] = { 0x3c208c16d87cfd47, 0x97816a916871ca8d, 0xb85045b68181585d, 0x30644e72e131a029 };
+    // 2^256 mod p and 2^512 mod p
+    static constexpr uint64_t R[4] = { 0xd35d438dc58f0d9d, 0x0a78eb28f5c70b3d, 0x666ea36f7879462c, 0x0e0a77c19a07df2f };
+    static constexpr uint64_t R2[4] = { 0xf32cfc5b538afa89, 0xb5e71911d44501fb, 0x47ab1eff0a417ff6, 0x06d89f71cab8351f };
+    // -p^-1 mod 2^64
+    static constexpr uint64_t P_INVERSE = 0x87d20782e4866389;
+
+    uint64_t limbs[4];
+
+    static Bn128Field fromLimbs(const uint64_t (&value)[4]) {
+      Bn128Field result;
+      for (size_t i = 0; i < 4; i++) result.limbs[i] = value[i];
+      return result;
+    }
+
+    // brings carry * 2^256 + limbs below p, for a value below 2p
+    void reduce(uint64_t carry) {
+      if (carry == 0 && belowModulus()) return;
+      uint64_t borrow = 0;
+      for (size_t i = 0; i < 4; i++) {
+        intx::uint128 difference = intx::uint128(limbs[i]) - P[i] - borrow;
+        limbs[i] = difference.lo;
+        borrow = difference.hi != 0 ? 1 : 0;
+      }
+    }
+
+    bool belowModulus() const {
+      for (size_t i = 4; i > 0; i--) {
+        if (limbs[i - 1] != P[i - 1]) return limbs[i - 1] < P[i - 1];
+      }
+      return false;
+    }
+};
+
+// c0 + c1 i with i^2 = -1
+class Bn128Field2 {
+  public:
+    Bn128Field c0;
+    Bn128Field c1;
+
+    Bn128Field2() {};
+    Bn128Field2(const Bn128Field& real, const Bn128Field& imaginary): c0(real), c1(imaginary) {};
+
+    static Bn128Field2 one() {
+      return Bn128Field2(Bn128Field::one(), Bn128Field());
+    }
+
+    // 9 + i, the non-residue the higher extensions are built on
+    static Bn128Field2 xi() {
+      return Bn128Field2(Bn128Field(9), Bn128Field::one());
+    }
+
+    bool isZero() const {
+      return c0.isZero() && c1.isZero();
+    }
+
+    bool operator==(const Bn128Field2& other) const {
+      return c0 == other.c0 && c1 == other.c1;
+    }
+
+    Bn128Field2 operator+(const Bn128Field2& other) const {
+      return Bn128Field2(c0 + other.c0, c1 + other.c1);
+    }
+
+    Bn128Field2 operator-(const Bn128Field2& other) const {
+      return Bn128Field2(c0 - other.c0, c1 - other.c1);
+    }
+
+    Bn128Field2 operator*(const Bn128Field2& other) const {
+      Bn128Field v0 = c0 * other.c0;
+      Bn128Field v1 = c1 * other.c1;
+      return Bn128Field2(v0 - v1, (c0 + c1) * (other.c0 + other.c1) - v0 - v1);
+    }
+
+    Bn128Field2 operator*(const Bn128Field& scalar) const {
+      return Bn128Field2(c0 * scalar, c1 * scalar);
+    }
+
+    Bn128Field2 square() const {
+      Bn128Field product = c0 * c1;
+      return Bn128Field2((c0 + c1) * (c0 - c1), product + product);
+    }
+
+    Bn128Field2 negate() const {
+      return Bn128Field2(c0.negate(), c1.negate());
+    }
+
+    // also the p-th power, since i^p = -i
+    Bn128Field2 conjugate() const {
+      return Bn128Field2(c0, c1.negate());
+    }
+
+    // (9 + i)(c0 + c1 i)
+    Bn128Field2 mulByXi() const {
+      Bn128Field c0x8 = c0 + c0;
+      c0x8 = c0x8 + c0x8;
+      c0x8 = c0x8 + c0x8;
+      Bn128Field c1x8 = c1 + c1;
+      c1x8 = c1x8 + c1x8;
+      c1x8 = c1x8 + c1x8;
+      return Bn128Field2(c0x8 + c0 - c1, c1x8 + c1 + c0);
+    }
+
+    Bn128Field2 inverse() const {
+      Bn128Field norm = (c0.square() + c1.square()).inverse();
+      return Bn128Field2(c0 * norm, (c1 * norm).negate());
+    }
+
+    Bn128Field2 power(const uint256_t& exponent) const {
+      Bn128Field2 result = one();
+      for (size_t i = 256; i > 0; i--) {
+        result = result.square();
+        if (((exponent >> (i - 1)) & 1) != 0) result = result * *this;
+      }
+      return result;
+    }
+};
+
+// c0 + c1 v + c2 v^2 with v^3 = 9 + i
+class Bn128Field6 {
+  public:
+    Bn128Field2 c0;
+    Bn128Field2 c1;
+    Bn128Field2 c2;
+
+    Bn128Field6() {};
+    Bn128Field6(const Bn128Field2& a, const Bn128Field2& b, const Bn128Field2& c): c0(a), c1(b), c2(c) {};
+
+    static Bn128Field6 one() {
+      return Bn128Field6(Bn128Field2::one(), Bn128Field2(), Bn128Field2());
+    }
+
+    bool operator==(const Bn128Field6& other) const {
+      return c0 == other.c0 && c1 == other.c1 && c2 == other.c2;
+    }
+
+    Bn128Field6 operator+(const Bn128Field6& other) const {
+      return Bn128Field6(c0 + other.c0, c1 + other.c1, c2 + other.c2);
+    }
+
+    Bn128Field6 operator-(const Bn128Field6& other) const {
+      return Bn128Field6(c0 - other.c0, c1 - other.c1, c2 - other.c2);
+    }
+
+    Bn128Field6 operator*(const Bn128Field6& other) const {
+      Bn128Field2 v0 = c0 * other.c0;
+      Bn128Field2 v1 = c1 * other.c1;
+      Bn128Field2 v2 = c2 * other.c2;
+      return Bn128Field6(
+        v0 + ((c1 + c2) * (other.c1 + other.c2) - v1 - v2).mulByXi(),
+        (c0 + c1) * (other.c0 + other.c1) - v0 - v1 + v2.mulByXi(),
+        (c0 + c2) * (other.c0 + other.c2) - v0 - v2 + v1
+      );
+    }
+
+    Bn128Field6 operator*(const Bn128Field2& scalar) const {
+      return Bn128Field6(c0 * scalar, c1 * scalar, c2 * scalar);
+    }
+
+    Bn128Field6 negate() const {
+      return Bn128Field6(c0.negate(), c1.negate(), c2.negate());
+    }
+
+    // by b0 + b1 v
+    Bn128Field6 mulBy01(const Bn128Field2& b0, const Bn128Field2& b1) const {
+      Bn128Field2 v0 = c0 * b0;
+      Bn128Field2 v1 = c1 * b1;
+      return Bn128Field6(
+        v0 + (c2 * b1).mulByXi(),
+        (c0 + c1) * (b0 + b1) - v0 - v1,
+        v1 + c2 * b0
+      );
+    }
+
+    // v (c0 + c1 v + c2 v^2)
+    Bn128Field6 mulByV() const {
+      return Bn128Field6(c2.mulByXi(), c0, c1);
+    }
+
+    Bn128Field6 inverse() const {
+      Bn128Field2 a = c0.square() - (c1 * c2).mulByXi();
+      Bn128Field2 b = c2.square().mulByXi() - c0 * c1;
+      Bn128Field2 c = c1.square() - c0 * c2;
+      Bn128Field2 norm = (c0 * a + (c2 * b + c1 * c).mulByXi()).inverse();
+      return Bn128Field6(a * norm, b * norm, c * norm);
+    }
+};
+
+// c0 + c1 w with w^2 = v, so w^6 = 9 + i
+class Bn128Field12 {
+  public:
+    Bn128Field6 c0;
+    Bn128Field6 c1;
+
+    Bn128Field12() {};
+    Bn128Field12(const Bn128Field6& a, const Bn128Field6& b): c0(a), c1(b) {};
+
+    static Bn128Field12 one() {
+      return Bn128Field12(Bn128Field6::one(), Bn128Field6());
+    }
+
+    bool operator==(const Bn128Field12& other) const {
+      return c0 == other.c0 && c1 == other.c1;
+    }
+
+    Bn128Field12 operator*(const Bn128Field12& other) const {
+      Bn128Field6 v0 = c0 * other.c0;
+      Bn128Field6 v1 = c1 * other.c1;
+      return Bn128Field12(v0 + v1.mulByV(), (c0 + c1) * (other.c0 + other.c1) - v0 - v1);
+    }
+
+    // by l0 + l1 w + l3 w^3, the shape of a Miller loop line
+    Bn128Field12 mulByLine(const Bn128Field2& l0, const Bn128Field2& l1, const Bn128Field2& l3) const {
+      Bn128Field6 v0 = c0 * l0;
+      Bn128Field6 v1 = c1.mulBy01(l1, l3);
+      return Bn128Field12(v0 + v1.mulByV(), (c0 + c1).mulBy01(l0 + l1, l3) - v0 - v1);
+    }
+
+    Bn128Field12 square() const {
+      Bn128Field6 product = c0 * c1;
+      Bn128Field6 c0c0 = (c0 + c1) * (c0 + c1.mulByV()) - product - product.mulByV();
+      return Bn128Field12(c0c0, product + product);
+    }
+
+    // the p^6-th power
+    Bn128Field12 conjugate() const {
+      return Bn128Field12(c0, c1.negate());
+    }
+
+    Bn128Field12 inverse() const {
+      Bn128Field6 norm = (c0 * c0 - (c1 * c1).mulByV()).inverse();
+      return Bn128Field12(c0 * norm, (c1 * norm).negate());
+    }
+
+    Bn128Field12 power(uint64_t exponent) const {
+      Bn128Field12 result = one();
+      for (size_t i = 64; i > 0; i--) {
+        result = result.square();
+        if (((exponent >> (i - 1)) & 1) != 0) result = result * *this;
+      }
+      return result;
+    }
+
+    /*
+      The p-th power. Writing the element as the sum of a_k w^k for k = 0..5 with a_k in Fp2,
+      each term becomes conj(a_k) w^k (9 + i)^(k (p - 1) / 6).
+    */
+    Bn128Field12 frobenius() const {
+      const std::array<Bn128Field2, 6>& gamma = frobeniusCoefficients();
+      return Bn128Field12(
+        Bn128Field6(c0.c0.conjugate(), c0.c1.conjugate() * gamma[2], c0.c2.conjugate() * gamma[4]),
+        Bn128Field6(c1.c0.conjugate() * gamma[1], c1.c1.conjugate() * gamma[3], c1.c2.conjugate() * gamma[5])
+      );
+    }
+
+    // (9 + i)^(k (p - 1) / 6)
+    static const std::array<Bn128Field2, 6>& frobeniusCoefficients() {
+      static const std::array<Bn128Field2, 6> gamma = [] {
+        std::array<Bn128Field2, 6> powers;
+        powers[0] = Bn128Field2::one();
+        powers[1] = Bn128Field2::xi().power((Bn128Field::MODULUS - 1) / 6);
+        for (size_t k = 2; k < 6; k++) powers[k] = powers[k - 1] * powers[1];
+        return powers;
+      }();
+      return gamma;
+    }
+};
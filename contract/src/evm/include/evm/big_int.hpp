@@ -8,8 +8,12 @@
 class BigInt {
   public:
     static uint256_t fromBigEndianBytes(const bytes_t& bytes) {
+      return fromBigEndianBytes(bytes.data(), bytes.size());
+    }
+
+    static uint256_t fromBigEndianBytes(const uint8_t* bytes, size_t size) {
       uint8_t data[WORD_SIZE];
-      uint8_t offset = WORD_SIZE - bytes.size();
+      uint8_t offset = WORD_SIZE - size;
       for (uint8_t i = 0; i < WORD_SIZE; i++) {
         data[i] = (i < offset) ? 0 : bytes[i - offset];
       }
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BLAKE2B_AVX2
+#include <immintrin.h>
+#endif
+
+/*
+  The BLAKE2b compression function F (RFC 7693) with the number of rounds as a parameter, for
+  the 0x09 precompile (EIP-152). x86-64 builds use AVX2 when the CPU has it, holding each row
+  of the 4x4 state in one register so the four G functions of a step run side by side; other
+  targets, WASM included, run the portable version.
+*/
+class Blake2b {
+  public:
+    static void compress(uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool final) {
+#if defined(BLAKE2B_AVX2)
+      static const bool avx2 = __builtin_cpu_supports("avx2");
+      if (avx2) {
+        compressAvx2(rounds, h, m, t, final);
+        return;
+      }
+#endif
+      compressPortable(rounds, h, m, t, final);
+    }
+
+    static void compressPortable(uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool final) {
+      uint64_t v[16];
+      for (size_t i = 0; i < 8; i++) {
+        v[i] = h[i];
+        v[i + 8] = IV[i];
+      }
+      v[12] ^= t[0];
+      v[13] ^= t[1];
+      if (final) v[14] = ~v[14];
+
+      for (uint32_t round = 0; round < rounds; round++) {
+        const uint8_t* s = SIGMA[round % 10];
+        g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+      }
+
+      for (size_t i = 0; i < 8; i++) h[i] ^= v[i] ^ v[i + 8];
+    }
+
+  private:
+    static constexpr uint64_t IV[8] = {
+      0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+      0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179
+    };
+
+    static constexpr uint8_t SIGMA[10][16] = {
+      { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+      { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+      { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+      { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+      { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+      { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+      { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+      { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+      { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+      { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 }
+    };
+
+    static uint64_t rotr(uint64_t x, unsigned n) {
+      return (x >> n) | (x << (64 - n));
+    }
+
+    static void g(uint64_t v[16], size_t a, size_t b, size_t c, size_t d, uint64_t x, uint64_t y) {
+      v[a] = v[a] + v[b] + x;
+      v[d] = rotr(v[d] ^ v[a], 32);
+      v[c] = v[c] + v[d];
+      v[b] = rotr(v[b] ^ v[c], 24);
+      v[a] = v[a] + v[b] + y;
+      v[d] = rotr(v[d] ^ v[a], 16);
+      v[c] = v[c] + v[d];
+      v[b] = rotr(v[b] ^ v[c], 63);
+    }
+
+#if defined(BLAKE2B_AVX2)
+    // the four G functions of a column or diagonal step, lane i of each row belonging to the i-th
+    __attribute__((target("avx2")))
+    static void g4(__m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i x, __m256i y) {
+      const __m256i rotate24 = _mm256_setr_epi8(
+        3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+        3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10
+      );
+      const __m256i rotate16 = _mm256_setr_epi8(
+        2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+        2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9
+      );
+
+      a = _mm256_add_epi64(_mm256_add_epi64(a, b), x);
+      d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1));
+      c = _mm256_add_epi64(c, d);
+      b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rotate24);
+      a = _mm256_add_epi64(_mm256_add_epi64(a, b), y);
+      d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rotate16);
+      c = _mm256_add_epi64(c, d);
+      b = _mm256_xor_si256(b, c);
+      b = _mm256_or_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i gather(const uint64_t m[16], const uint8_t* s) {
+      return _mm256_set_epi64x(
+        static_cast<long long>(m[s[6]]), static_cast<long long>(m[s[4]]),
+        static_cast<long long>(m[s[2]]), static_cast<long long>(m[s[0]])
+      );
+    }
+
+    __attribute__((target("avx2")))
+    static void compressAvx2(uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool final) {
+      __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h));
+      __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + 4));
+      __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(IV));
+      __m256i d = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(IV + 4)),
+        _mm256_set_epi64x(0, final ? -1 : 0, static_cast<long long>(t[1]), static_cast<long long>(t[0]))
+      );
+
+      for (uint32_t round = 0; round < rounds; round++) {
+        const uint8_t* s = SIGMA[round % 10];
+        g4(a, b, c, d, gather(m, s), gather(m, s + 1));
+
+        // rotate rows so the diagonals line up as columns, then back
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+        g4(a, b, c, d, gather(m, s + 8), gather(m, s + 9));
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+      }
+
+      __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h));
+      __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + 4));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(h), _mm256_xor_si256(low, _mm256_xor_si256(a, c)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(h + 4), _mm256_xor_si256(high, _mm256_xor_si256(b, d)));
+    }
+#endif
+};
@@ -30,6 +30,10 @@ class ByteReader {
       return position >= bytes->size();
     }
 
+    uint64_t offset() {
+      return position;
+    }
+
     uint64_t pc() {
       return position - 1;
     }
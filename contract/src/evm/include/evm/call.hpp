@@ -7,50 +7,37 @@
 #include <evm/pending_state.hpp>
 #include <evm/context.hpp>
 #include <evm/memory.hpp>
+#include <evm/execution_state.hpp>
+#include <evm/precompile.hpp>
 
 class Call {
   public:
     static call_result_t call(
       uint16_t stackDepth,
       CallType callType,
-      std::shared_ptr<Memory> memory,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<Operation> operation,
-      std::shared_ptr<GasCalculation> gasCalculation,
-      std::shared_ptr<External> external,
-      std::shared_ptr<PendingState> pendingState
+      Memory& memory,
+      Context& context,
+      Operation& operation,
+      GasCalculation& gasCalculation,
+      const std::shared_ptr<External>& external,
+      const std::shared_ptr<PendingState>& pendingState
     ) {
 
       uint16_t nextStackDepth = stackDepth + 1;
       pendingState->currentStackDepth = nextStackDepth;
+      checkpoint_t checkpoint = pendingState->checkpoint();
 
-      std::shared_ptr<StackMachine> stack =  std::make_shared<StackMachine>();
-      std::shared_ptr<Gasometer> gasometer = std::make_shared<Gasometer>(context->gas);
+      StackMachine& stack = pendingState->frames.stack(nextStackDepth);
+      Gasometer gasometer(context.gas);
 
-      VM vm(stack, gasometer);
+      ExecutionState state(nextStackDepth, context, memory, stack, gasometer, pendingState, external);
 
-      if (Overflow::uint256Cast(context->value).first > 0 && callType == CallType::ACTION_CALL) {
-        emplace_t result = external->transfer(context->sender, context->address, context->value, pendingState);
-        switch (result.first) {
-          case EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND:
-          case EmplaceResult::EMPLACE_CODE_ALREADY_EXISTS:
-            return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, TrapKind::TRAP_INVALID_CODE_ADDRESS);
-          case EmplaceResult::EMPLACE_INSUFFICIENT_FUNDS:
-            return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, TrapKind::TRAP_INSUFFICIENT_FUNDS);
-          case EmplaceResult::EMPLACE_SUCCESS:
-            break;
-        }
+      if (Overflow::uint256Cast(context.value).first > 0 && callType == CallType::ACTION_CALL) {
+        emplace_t result = external->transfer(context.sender, context.address, context.value, pendingState);
+        if (result.first != EmplaceResult::EMPLACE_SUCCESS) return transferFailed(result);
       }
 
-      exec_result_t vm_result = vm.execute(
-        nextStackDepth,
-        context,
-        memory, 
-        operation,
-        gasCalculation,
-        pendingState, 
-        external
-      );
+      exec_result_t vm_result = VM::execute(state, operation, gasCalculation);
 
       switch (vm_result.first) {
         case ExecResult::DONE_VOID:
@@ -69,27 +56,75 @@ class Call {
             if (vmData.apply) {
               return std::make_pair(MessageCallResult::MESSAGE_CALL_RETURN, messageCallReturn);
             } else {
-              pendingState->revert(nextStackDepth);
+              pendingState->revert(checkpoint);
               return std::make_pair(MessageCallResult::MESSAGE_CALL_REVERTED, messageCallReturn);
             }
           }
         case ExecResult::VM_TRAP:
           {
-            pendingState->revert(nextStackDepth);
+            pendingState->revert(checkpoint);
             trap_t trap = std::get<trap_t>(vm_result.second);
             return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, trap);
           }
         case ExecResult::VM_OUT_OF_GAS:
           {
-            pendingState->revert(nextStackDepth);
+            pendingState->revert(checkpoint);
             return std::make_pair(MessageCallResult::MESSAGE_CALL_OUT_OF_GAS, 0);
           }
         case ExecResult::CONTINUE:
           {
             // in reality this is never called
-            pendingState->revert(nextStackDepth);
+            pendingState->revert(checkpoint);
             return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, 0);
           }
       };
     }
+
+    // runs a precompiled contract; the output is left at the start of memory like a RETURN
+    static call_result_t precompile(
+      uint16_t stackDepth,
+      CallType callType,
+      Memory& memory,
+      const uint256_t& precompileAddress,
+      const uint256_t& senderAddress,
+      const uint256_t& receiveAddress,
+      const uint256_t& value,
+      gas_t gas,
+      const bytes_t& input,
+      const std::shared_ptr<External>& external,
+      const std::shared_ptr<PendingState>& pendingState
+    ) {
+      pendingState->currentStackDepth = stackDepth + 1;
+      checkpoint_t checkpoint = pendingState->checkpoint();
+
+      if (Overflow::uint256Cast(value).first > 0 && callType == CallType::ACTION_CALL) {
+        emplace_t result = external->transfer(senderAddress, receiveAddress, value, pendingState);
+        if (result.first != EmplaceResult::EMPLACE_SUCCESS) return transferFailed(result);
+      }
+
+      gas_t cost = Precompile::gas(precompileAddress, input);
+      if (cost > gas) {
+        pendingState->revert(checkpoint);
+        return std::make_pair(MessageCallResult::MESSAGE_CALL_OUT_OF_GAS, 0);
+      }
+
+      precompile_result_t result = Precompile::run(precompileAddress, input, *external, *pendingState);
+      if (result.first == PrecompileResult::PRECOMPILE_FAILED) {
+        pendingState->revert(checkpoint);
+        return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, TrapKind::TRAP_PRECOMPILE_FAILED);
+      }
+
+      const bytes_t& output = result.second;
+      memory.expand(output.size());
+      memory.writeSlice(0, output.size(), output);
+      MessageCallReturn messageCallReturn { gas - cost, 0, output.size() };
+      return std::make_pair(MessageCallResult::MESSAGE_CALL_RETURN, messageCallReturn);
+    }
+
+  private:
+    static call_result_t transferFailed(const emplace_t& result) {
+      if (result.first == EmplaceResult::EMPLACE_INSUFFICIENT_FUNDS) 
+        return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, TrapKind::TRAP_INSUFFICIENT_FUNDS);
+      return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, TrapKind::TRAP_INVALID_CODE_ADDRESS);
+    }
 };
\ No newline at end of file
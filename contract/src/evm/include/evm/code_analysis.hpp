@@ -0,0 +1,150 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <evm/types.h>
+#include <evm/opcode.h>
+#include <evm/gas_types.h>
+#include <evm/instruction.hpp>
+#include <evm/jumps.hpp>
+
+/*
+  A straight run of fixed-cost stack instructions. stackMin and stackMax are the lowest
+  and highest stack height reached relative to the height at block entry.
+*/
+struct BasicBlock {
+  uint64_t start;
+  uint64_t end;
+  gas_t gas;
+  int32_t stackMin;
+  int32_t stackMax;
+};
+typedef BasicBlock basic_block_t;
+
+class CodeAnalysis {
+  public:
+    explicit CodeAnalysis(std::shared_ptr<bytes_t> code):
+      codeSize(code->size()),
+      jumps(Jumps::findDestinations(code)),
+      blocks(findBlocks(*code)) {
+      };
+
+    bool isJumpDestination(uint64_t position) const {
+      return Jumps::isDestination(position, jumps);
+    }
+
+    // index of the first block starting at or after position
+    size_t findBlock(uint64_t position) const {
+      return std::lower_bound(
+        blocks.begin(), blocks.end(), position, [](const basic_block_t& block, uint64_t position) {
+          return block.start < position;
+        }
+      ) - blocks.begin();
+    }
+
+    /*
+      Instructions the interpreter runs inline; their gas is fixed and they only touch the stack and pc
+    */
+    static constexpr bool isBlockInstruction(uint8_t opcode) {
+      switch (opcode) {
+        case Opcode::STOP:
+        case Opcode::ADD:
+        case Opcode::MUL:
+        case Opcode::SUB:
+        case Opcode::DIV:
+        case Opcode::MOD:
+        case Opcode::LT:
+        case Opcode::GT:
+        case Opcode::EQ:
+        case Opcode::ISZERO:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+        case Opcode::NOT:
+        case Opcode::SHL:
+        case Opcode::SHR:
+        case Opcode::POP:
+        case Opcode::JUMP:
+        case Opcode::JUMPI:
+        case Opcode::PC:
+        case Opcode::GAS:
+        case Opcode::JUMPDEST:
+          return true;
+        default:
+          return (opcode >= Opcode::PUSH1 && opcode <= Opcode::PUSH32)
+            || (opcode >= Opcode::DUP1 && opcode <= Opcode::DUP16)
+            || (opcode >= Opcode::SWAP1 && opcode <= Opcode::SWAP16);
+      }
+    }
+
+    // GAS observes the gas left so it has to be the last charge of its block
+    static bool endsBlock(uint8_t opcode) {
+      return opcode == Opcode::STOP || opcode == Opcode::JUMP || opcode == Opcode::JUMPI || opcode == Opcode::GAS;
+    }
+
+    static std::vector<basic_block_t> findBlocks(const bytes_t& code) {
+      std::vector<basic_block_t> blocks;
+      const uint64_t size = code.size();
+      uint64_t position = 0;
+
+      while (position < size) {
+        uint8_t opcode = code[position];
+        if (!isBlockInstruction(opcode)) {
+          position++;
+          continue;
+        }
+
+        basic_block_t block { position, position, 0, 0, 0 };
+        int32_t height = 0;
+        do {
+          instruct_t instruction = Instruction::values[opcode];
+          block.gas += opcode == Opcode::JUMPDEST ? JUMPDEST_GAS : TIER_STEP_GAS[instruction.tier];
+          block.stackMin = std::min(block.stackMin, height - instruction.args);
+          height += instruction.ret - instruction.args;
+          block.stackMax = std::max(block.stackMax, height);
+          position += Instruction::pushBytes(instruction) + 1;
+          if (endsBlock(opcode)) break;
+          if (position >= size) break;
+          opcode = code[position];
+        } while (isBlockInstruction(opcode) && opcode != Opcode::JUMPDEST);
+
+        block.end = position;
+        blocks.push_back(block);
+      }
+
+      return blocks;
+    }
+
+    uint64_t codeSize;
+    jump_map_t jumps;
+    std::vector<basic_block_t> blocks;
+};
+
+/*
+  Lives for a whole transaction so that code executed by several frames
+  (proxies, libraries) is analysed once.
+*/
+class CodeAnalysisCache {
+  public:
+    std::shared_ptr<CodeAnalysis> get(const uint256_t& codeHash, std::shared_ptr<bytes_t> code) {
+      auto found = analyses.find(codeHash);
+      if (found != analyses.end() && found->second->codeSize == code->size()) {
+        hits++;
+        return found->second;
+      }
+
+      misses++;
+      std::shared_ptr<CodeAnalysis> analysis = std::make_shared<CodeAnalysis>(code);
+      analyses[codeHash] = analysis;
+      return analysis;
+    }
+
+    size_t size() const {
+      return analyses.size();
+    }
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  private:
+    std::map<uint256_t, std::shared_ptr<CodeAnalysis>> analyses;
+};
@@ -5,6 +5,10 @@
 #include <evm/transaction.hpp>
 #include <evm/hash.hpp>
 
+/*
+  codeHash keys the CodeAnalysisCache. Calls take it from the account row through
+  External::codeHash, so only initcode and the bytecode given to execute are hashed here.
+*/
 class Context {
   public:
     explicit Context(
@@ -103,6 +107,7 @@ class Context {
       const gas_t gasLimit,
       const uint256_t& gasPrice,
       const uint256_t& value,
+      const uint256_t& codeHash,
       std::shared_ptr<bytes_t> code,
       std::shared_ptr<bytes_t> data
     ) {
@@ -115,7 +120,7 @@ class Context {
         env.difficulty,
         env.blockHash,
         toAddress, /* codeAddress */
-        Hash::keccak256Word(code), 
+        codeHash, 
         toAddress, /* address */
         senderAddress, /* sender */
         senderAddress, /* origin */
@@ -128,8 +133,8 @@ class Context {
       );
     }
 
-    static std::shared_ptr<Context> makeInnerCall(
-      std::shared_ptr<Context> parentContext,
+    static Context makeInnerCall(
+      const Context& parentContext,
       const uint256_t& codeExecutionAddress, // the address to execute the code as
       const uint256_t& codeAddress, // the address to fetch the code from
       const uint256_t& receiveAddress,
@@ -138,22 +143,23 @@ class Context {
       const uint256_t& gasPrice,
       const uint256_t& value,
       bool isStatic,
+      const uint256_t& codeHash,
       std::shared_ptr<bytes_t> code,
       std::shared_ptr<bytes_t> data
     ) {
-      return std::make_shared<Context>(
-        parentContext->chainId,
-        parentContext->blockNumber,
-        parentContext->timestamp,
-        parentContext->gasLimit,
-        parentContext->coinbase,
-        parentContext->difficulty,
-        parentContext->blockHash,
+      return Context(
+        parentContext.chainId,
+        parentContext.blockNumber,
+        parentContext.timestamp,
+        parentContext.gasLimit,
+        parentContext.coinbase,
+        parentContext.difficulty,
+        parentContext.blockHash,
         codeExecutionAddress,
-        Hash::keccak256Word(code),
+        codeHash,
         receiveAddress, 
         senderAddress, 
-        parentContext->origin, 
+        parentContext.origin, 
         gas,
         gasPrice,
         value,
@@ -163,28 +169,28 @@ class Context {
       );
     } 
 
-    static std::shared_ptr<Context> makeInnerCreate(
-      std::shared_ptr<Context> parentContext,
+    static Context makeInnerCreate(
+      const Context& parentContext,
       const uint256_t& codeAddress,
       const gas_t& gas,
       const uint256_t& value,
       std::shared_ptr<bytes_t> code
     ) {
-      return std::make_shared<Context>(
-        parentContext->chainId,
-        parentContext->blockNumber,
-        parentContext->timestamp,
-        parentContext->gasLimit,
-        parentContext->coinbase,
-        parentContext->difficulty,
-        parentContext->blockHash,
+      return Context(
+        parentContext.chainId,
+        parentContext.blockNumber,
+        parentContext.timestamp,
+        parentContext.gasLimit,
+        parentContext.coinbase,
+        parentContext.difficulty,
+        parentContext.blockHash,
         codeAddress, /* codeAddress */
         Hash::keccak256Word(code),
         codeAddress, /* address */
         codeAddress, /* sender */
-        parentContext->origin, /* origin */
+        parentContext.origin, /* origin */
         gas,
-        parentContext->gasPrice,
+        parentContext.gasPrice,
         value,
         false,
         code,
@@ -8,6 +8,8 @@
 #include <evm/overflow.hpp>
 #include <evm/hex.hpp>
 #include <evm/external.h>
+#include <evm/transaction.hpp>
+#include <evm/address.hpp>
 
 class Execute {
   public:
@@ -76,10 +78,10 @@ class Execute {
             callResult = Call::call(
               0,
               CallType::ACTION_CREATE,
-              memory,
-              context,
-              operation,
-              gasCalculation,
+              *memory,
+              *context,
+              *operation,
+              *gasCalculation,
               external,
               pendingState
             );
@@ -119,6 +121,25 @@ class Execute {
           }
         case TransactionActionType::TRANSACTION_CALL:
           {
+            if (Precompile::exists(toAddress)) {
+              return Call::precompile(
+                0,
+                CallType::ACTION_CALL,
+                *memory,
+                toAddress,
+                senderAddress,
+                toAddress,
+                value,
+                gasLimit,
+                *data,
+                external,
+                pendingState
+              );
+            }
+
+            if (isPlainTransfer(toAddress, *external, pendingState)) 
+              return transfer(senderAddress, toAddress, value, gasLimit, external, pendingState);
+
             std::shared_ptr<bytes_t> code = std::make_shared<bytes_t>(external->code(toAddress, pendingState));
 
             std::shared_ptr<Context> context = Context::makeCall(
@@ -128,6 +149,7 @@ class Execute {
               gasLimit,
               gasPrice,
               value,
+              external->codeHash(toAddress, pendingState),
               code, 
               data
             );
@@ -135,26 +157,78 @@ class Execute {
             callResult = Call::call(
               0,
               CallType::ACTION_CALL,
-              memory,
-              context,
-              operation,
-              gasCalculation,
+              *memory,
+              *context,
+              *operation,
+              *gasCalculation,
               external,
               pendingState
             );
 
-            if (callResult.first == MessageCallResult::MESSAGE_CALL_RETURN) {
-              MessageCallReturn messageCallReturn = std::get<MessageCallReturn>(callResult.second);
-              if (messageCallReturn.size > 0) 
-                eosio::print("return" + Hex::bytesToWordOutput(memory->memory, messageCallReturn.offset, messageCallReturn.size));
-            }
-
             break;
         }
       }
       return callResult;
     }
 
+    static bool isPlainTransfer(const uint256_t& toAddress, External& external, const std::shared_ptr<PendingState>& pendingState) {
+      return !Precompile::exists(toAddress) && external.codeSize(toAddress, pendingState) == 0;
+    }
+
+    // a call to an address without code only moves value, so the VM is skipped entirely
+    static call_result_t transfer(
+      const uint256_t& senderAddress,
+      const uint256_t& toAddress,
+      const uint256_t& value,
+      gas_t gasLimit,
+      const std::shared_ptr<External>& external,
+      const std::shared_ptr<PendingState>& pendingState
+    ) {
+      pendingState->currentStackDepth = 1;
+      if (value > 0) {
+        emplace_t result = external->transfer(senderAddress, toAddress, value, pendingState);
+        switch (result.first) {
+          case EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND:
+          case EmplaceResult::EMPLACE_CODE_ALREADY_EXISTS:
+            return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, TrapKind::TRAP_INVALID_CODE_ADDRESS);
+          case EmplaceResult::EMPLACE_INSUFFICIENT_FUNDS:
+            return std::make_pair(MessageCallResult::MESSAGE_CALL_FAILED, TrapKind::TRAP_INSUFFICIENT_FUNDS);
+          case EmplaceResult::EMPLACE_SUCCESS:
+            break;
+        }
+      }
+      return std::make_pair(MessageCallResult::MESSAGE_CALL_SUCCESS, gasLimit);
+    }
+
+    static call_result_t transaction(
+      const uint256_t& senderAddress,
+      const uint64_t nonce,
+      const env_t& env,
+      const transaction_view_t& tx,
+      std::shared_ptr<Memory> memory,
+      std::shared_ptr<Operation> operation,
+      std::shared_ptr<GasCalculation> gasCalculation,
+      std::shared_ptr<External> external,
+      std::shared_ptr<PendingState> pendingState
+    ) {
+      return transaction(
+        senderAddress,
+        nonce,
+        env,
+        tx.type,
+        tx.gas,
+        tx.gasPrice,
+        tx.value,
+        std::make_shared<bytes_t>(tx.data, tx.data + tx.dataSize),
+        tx.to,
+        memory,
+        operation,
+        gasCalculation,
+        external,
+        pendingState
+      );
+    }
+
     static call_result_t code(
       const uint256_t& senderAddress,
       const env_t& env,
@@ -171,7 +245,7 @@ class Execute {
       std::shared_ptr<PendingState> pendingState
     ) {
 
-      std::shared_ptr<Memory> memory = std::make_shared<Memory>();
+      Memory memory;
 
       std::shared_ptr<Context> context = Context::makeCodeCall(
         env,
@@ -187,9 +261,9 @@ class Execute {
         0,
         CallType::ACTION_STATIC_CALL,
         memory,
-        context,
-        operation,
-        gasCalculation,
+        *context,
+        *operation,
+        *gasCalculation,
         external,
         pendingState
       );
@@ -0,0 +1,47 @@
+#pragma once
+#include <memory>
+#include <evm/types.h>
+#include <evm/byte_reader.hpp>
+#include <evm/context.hpp>
+#include <evm/memory.hpp>
+#include <evm/stack.hpp>
+#include <evm/pending_state.hpp>
+#include <evm/external.h>
+
+class Gasometer;
+
+/*
+  Everything a single frame works on. Instruction handlers and gas calculations take it by
+  reference; the stack, memory, context and gasometer are borrowed from whoever set up the frame.
+*/
+class ExecutionState {
+  public:
+    ExecutionState(
+      uint16_t stackDepthArg,
+      Context& contextArg,
+      Memory& memoryArg,
+      StackMachine& stackArg,
+      Gasometer& gasometerArg,
+      std::shared_ptr<PendingState> pendingStateArg,
+      std::shared_ptr<External> externalArg
+    ):
+      stackDepth(stackDepthArg),
+      context(contextArg),
+      memory(memoryArg),
+      stack(stackArg),
+      gasometer(gasometerArg),
+      reader(0),
+      returnData(),
+      pendingState(pendingStateArg),
+      external(externalArg) {
+      };
+    uint16_t stackDepth;
+    Context& context;
+    Memory& memory;
+    StackMachine& stack;
+    Gasometer& gasometer;
+    ByteReader reader;
+    bytes_t returnData;
+    std::shared_ptr<PendingState> pendingState;
+    std::shared_ptr<External> external;
+};
@@ -2,6 +2,8 @@
 #include <memory>
 #include "types.h"
 #include <evm/pending_state.hpp>
+#include <evm/hash.hpp>
+#include <evm/secp256k1.hpp>
 
 class External {
 public:
@@ -12,10 +14,26 @@ public:
     const uint256_t& address, 
     std::shared_ptr<PendingState> pendingState
   ) { return bytes_t(); };
+  virtual uint64_t codeSize(
+    const uint256_t& address, 
+    std::shared_ptr<PendingState> pendingState
+  ) { return code(address, pendingState).size(); };
+  virtual uint256_t codeHash(
+    const uint256_t& address, 
+    std::shared_ptr<PendingState> pendingState
+  ) { return Hash::keccak256Word(code(address, pendingState)); };
   virtual uint256_t balance(
     const uint256_t& addressWord, 
     std::shared_ptr<PendingState> pendingState
   ) { return 0.0; };
+  virtual bytes_t sha256(const bytes_t& input) { return Hash::sha256(input); };
+  virtual bytes_t ripemd160(const bytes_t& input) { return Hash::ripemd160(input); };
+  virtual bytes_t ecrecover(
+    const uint256_t& hash,
+    uint8_t recoveryId,
+    const uint256_t& r,
+    const uint256_t& s
+  ) { return Secp256k1::recover(hash, recoveryId, r, s); };
   virtual uint256_t storageAt(const uint256_t& key, const uint256_t& codeAddress) { return uint256_t(0); };
   virtual emplace_t selfdestruct(
     const uint256_t& contractAddressWord, 
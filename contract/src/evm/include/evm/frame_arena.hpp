@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <evm/types.h>
+#include <evm/stack.hpp>
+#include <evm/memory.hpp>
+
+/*
+  Stacks and memories for nested frames, one slot per call depth. Only one frame is live at
+  a given depth, so a slot is handed out again as soon as the next sibling call starts; the
+  parent reads a child's return data before that happens. Slots keep their capacity between
+  frames so a transaction pays for each depth's buffers once.
+*/
+class FrameArena {
+  public:
+    StackMachine& stack(uint16_t depth) {
+      StackMachine& stack = slot(stacks, depth);
+      stack.reset();
+      return stack;
+    }
+
+    Memory& memory(uint16_t depth) {
+      Memory& memory = slot(memories, depth);
+      memory.reset();
+      return memory;
+    }
+
+    size_t depth() const {
+      return std::max(stacks.size(), memories.size());
+    }
+
+  private:
+    std::vector<std::unique_ptr<StackMachine>> stacks;
+    std::vector<std::unique_ptr<Memory>> memories;
+
+    template <typename T>
+    static T& slot(std::vector<std::unique_ptr<T>>& slots, uint16_t depth) {
+      if (depth >= slots.size()) slots.resize(depth + 1);
+      if (!slots[depth]) slots[depth] = std::make_unique<T>();
+      return *slots[depth];
+    }
+};
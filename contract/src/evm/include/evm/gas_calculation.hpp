@@ -7,6 +7,7 @@
 #include <evm/external.h>
 #include <evm/stack.hpp>
 #include <evm/context.hpp>
+#include <evm/execution_state.hpp>
 #include <evm/overflow.hpp>
 
 class GasCalculation {
@@ -15,9 +16,7 @@ class GasCalculation {
     gas_t defaultGas,
     gas_t currentGas,
     gas_t currentMemorySize,
-    std::shared_ptr<Context> context,
-    std::shared_ptr<StackMachine> stack,
-    std::shared_ptr<External> external
+    ExecutionState& state
   );
   public:
     calculate_t values[256];
@@ -59,11 +58,9 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      return gas(1);
+      return gas(JUMPDEST_GAS);
     }
 
     gas_result_t sstore(
@@ -71,17 +68,15 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       if (currentGas <= CALL_STIPEND) {
         return outOfGas();
       }
 
-      uint256_t address = stack->peek(0);
-      uint256_t newVal = stack->peek(1);
-      uint256_t word = external->storageAt(address, context->codeAddress);
+      uint256_t address = state.stack.peek(0);
+      uint256_t newVal = state.stack.peek(1);
+      uint256_t word = state.external->storageAt(address, state.context.codeAddress);
 
       gas_t storeGasCost;
       if (word == 0 && newVal != 0) {
@@ -98,9 +93,7 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       return gas(SLOAD_GAS);
     }
@@ -110,9 +103,7 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       return gas(BALANCE_GAS);
     }
@@ -122,9 +113,7 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       return gas(EXTCODESIZE_GAS);
     }
@@ -134,9 +123,7 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       return gas(EXTCODEHASH_GAS);
     }
@@ -146,9 +133,7 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       return gas(0);
     }
@@ -158,11 +143,9 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(0)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(0)).first;
       return gasMem(defaultGas, memNeeded(instructionGas, 32));
     }
 
@@ -171,11 +154,9 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(0)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(0)).first;
       return gasMem(defaultGas, memNeeded(instructionGas, 1));
     }
 
@@ -184,12 +165,10 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(0)).first;
-      gas_t memoryNeeded = Overflow::uint256Cast(stack->peek(1)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(0)).first;
+      gas_t memoryNeeded = Overflow::uint256Cast(state.stack.peek(1)).first;
       return gasMem(defaultGas, memNeeded(instructionGas, memoryNeeded));
     }
 
@@ -198,13 +177,11 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(0)).first;
-      gas_t memoryNeeded = Overflow::uint256Cast(stack->peek(1)).first;
-      gas_t words = Overflow::toWordSize(stack->peek(1)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(0)).first;
+      gas_t memoryNeeded = Overflow::uint256Cast(state.stack.peek(1)).first;
+      gas_t words = Overflow::toWordSize(state.stack.peek(1)).first;
       gas_t gas = SHA3_GAS + SHA3_WORD_GAS * words;
       return gasMem(gas, memNeeded(instructionGas, memoryNeeded));
     }
@@ -214,12 +191,10 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(0)).first;
-      gas_t copySize = Overflow::uint256Cast(stack->peek(2)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(0)).first;
+      gas_t copySize = Overflow::uint256Cast(state.stack.peek(2)).first;
       return gasMemCopy(
         defaultGas, 
         memNeeded(instructionGas, copySize), 
@@ -232,12 +207,10 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(1)).first;
-      gas_t copySize = Overflow::uint256Cast(stack->peek(3)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(1)).first;
+      gas_t copySize = Overflow::uint256Cast(state.stack.peek(3)).first;
       return gasMemCopy(
         EXTCODECOPY_BASE_GAS, 
         memNeeded(instructionGas, copySize), 
@@ -250,12 +223,10 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(0)).first;
-      gas_t memoryNeeded = Overflow::uint256Cast(stack->peek(1)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(0)).first;
+      gas_t memoryNeeded = Overflow::uint256Cast(state.stack.peek(1)).first;
       uint8_t noOfTopics = Instruction::logTopics(instruction);
       gas_t logGas = LOG_GAS + LOG_TOPIC_GAS * noOfTopics;
       gas_t dataGas = memoryNeeded * LOG_DATA_GAS;
@@ -268,16 +239,14 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       gas_t gas = CALL_GAS;
-      gas_t value = Overflow::uint256Cast(stack->peek(2)).first;
-      gas_t argOffset = Overflow::uint256Cast(stack->peek(3)).first;
-      gas_t argLength = Overflow::uint256Cast(stack->peek(4)).first;
-      gas_t retOffset = Overflow::uint256Cast(stack->peek(5)).first;
-      gas_t retLength = Overflow::uint256Cast(stack->peek(6)).first;
+      gas_t value = Overflow::uint256Cast(state.stack.peek(2)).first;
+      gas_t argOffset = Overflow::uint256Cast(state.stack.peek(3)).first;
+      gas_t argLength = Overflow::uint256Cast(state.stack.peek(4)).first;
+      gas_t retOffset = Overflow::uint256Cast(state.stack.peek(5)).first;
+      gas_t retLength = Overflow::uint256Cast(state.stack.peek(6)).first;
 
       gas_t mem = std::max(
         memNeeded(argOffset, argLength),
@@ -289,7 +258,7 @@ class GasCalculation {
         gas = gas + CALL_VALUE_TRANSFER_GAS;
       }
 
-      gas_t instructionGas = Overflow::uint256Cast(stack->peek(0)).first;
+      gas_t instructionGas = Overflow::uint256Cast(state.stack.peek(0)).first;
 
       return gasMemProvided(gas, mem, instructionGas);
     }
@@ -299,20 +268,18 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t argOffset = Overflow::uint256Cast(stack->peek(2)).first;
-      gas_t argLength = Overflow::uint256Cast(stack->peek(3)).first;
-      gas_t retOffset = Overflow::uint256Cast(stack->peek(4)).first;
-      gas_t retLength = Overflow::uint256Cast(stack->peek(5)).first;
+      gas_t argOffset = Overflow::uint256Cast(state.stack.peek(2)).first;
+      gas_t argLength = Overflow::uint256Cast(state.stack.peek(3)).first;
+      gas_t retOffset = Overflow::uint256Cast(state.stack.peek(4)).first;
+      gas_t retLength = Overflow::uint256Cast(state.stack.peek(5)).first;
 
       gas_t mem = std::max(
         memNeeded(argOffset, argLength),
         memNeeded(retOffset, retLength)
       );
-      gas_t requested = Overflow::uint256Cast(stack->peek(0)).first;
+      gas_t requested = Overflow::uint256Cast(state.stack.peek(0)).first;
       return gasMemProvided(CALL_GAS, mem, requested);
     }
 
@@ -321,12 +288,10 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t start = Overflow::uint256Cast(stack->peek(1)).first;
-      gas_t len = Overflow::uint256Cast(stack->peek(2)).first;
+      gas_t start = Overflow::uint256Cast(state.stack.peek(1)).first;
+      gas_t len = Overflow::uint256Cast(state.stack.peek(2)).first;
       gas_t gas = CREATE_GAS;
       gas_t mem = memNeeded(start, len);
       return gasMemProvided(gas, mem, 0);
@@ -337,12 +302,10 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t start = Overflow::uint256Cast(stack->peek(1)).first;
-      gas_t len = Overflow::uint256Cast(stack->peek(2)).first;
+      gas_t start = Overflow::uint256Cast(state.stack.peek(1)).first;
+      gas_t len = Overflow::uint256Cast(state.stack.peek(2)).first;
 
       gas_t word = Overflow::toWordSize(len).first;
       gas_t wordGas = SHA3_WORD_GAS * word;
@@ -357,11 +320,9 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
-      gas_t exponent = Overflow::uint256Cast(stack->peek(1)).first;
+      gas_t exponent = Overflow::uint256Cast(state.stack.peek(1)).first;
       gas_t bytes = Overflow::uint256Cast((intx::count_significant_words<uint8_t>(exponent) + 7) / 8).first;
       gas_t cost = EXP_GAS + EXP_BYTE_GAS * bytes;
       return gas(cost);
@@ -372,9 +333,7 @@ class GasCalculation {
       gas_t defaultGas,
       gas_t currentGas,
       gas_t currentMemorySize,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      ExecutionState& state
     ) {
       return gas(BLOCK_HASH_GAS);
     }
@@ -3,6 +3,7 @@
 
 constexpr uint8_t TIER_STEP_GAS[] = { 0, 2, 3, 5, 8, 10, 20, 0 };
 
+const size_t JUMPDEST_GAS = 1;
 const size_t CALL_STIPEND = 2300;
 const size_t SSTORE_SET_GAS = 20000;
 const size_t SSTORE_RESET_GAS = 5000;
@@ -29,6 +30,9 @@ const size_t COPY_GAS = 3;
 const size_t MEMORY_GAS = 3;
 const size_t QUAD_COEFF_DIV = 512;
 const size_t SUB_GAS_CAP_DIVISOR = 64;
+const size_t TX_GAS = 21000;
+const size_t TX_DATA_ZERO_GAS = 4;
+const size_t TX_DATA_NON_ZERO_GAS = 68;
 
 enum GasometerResult {
   GASOMETER_RESULT_OK,
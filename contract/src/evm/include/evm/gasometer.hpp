@@ -7,6 +7,7 @@
 #include <evm/stack.hpp>
 #include <evm/gas_calculation.hpp>
 #include <evm/context.hpp>
+#include <evm/execution_state.hpp>
 #include <evm/gas_types.h>
 
 class Gasometer {
@@ -21,10 +22,8 @@ class Gasometer {
       uint8_t opcode,
       instruct_t instruction,
       gas_t currentMemorySize,
-      std::shared_ptr<GasCalculation> gasCalculation,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<StackMachine> stack,
-      std::shared_ptr<External> external
+      GasCalculation& gasCalculation,
+      ExecutionState& state
     ) {
       uint8_t tier = Instruction::tier(instruction);
       uint8_t tierGas = TIER_STEP_GAS[tier];
@@ -63,15 +62,13 @@ class Gasometer {
         case Opcode::EXP:
         case Opcode::BLOCKHASH:
           result = std::invoke(
-            gasCalculation->values[opcode], 
+            gasCalculation.values[opcode], 
             gasCalculation, 
             instruction,
             defaultGas,
             currentGas,
             currentMemorySize,
-            context,
-            stack,
-            external
+            state
           );
           break;
         default:
@@ -4,6 +4,8 @@
 #include <keccak/keccak.hpp>
 #include <evm/types.h>
 #include <evm/big_int.hpp>
+#include <evm/sha256.hpp>
+#include <evm/ripemd160.hpp>
 
 class Hash {
   public:
@@ -14,6 +16,26 @@ class Hash {
       return keccak256Word(word1Bytes);
     }
 
+    // keccak256WordPair of each pair, hashing several at once
+    static std::vector<uint256_t> keccak256WordPairs(const std::vector<std::pair<uint256_t, uint256_t>>& pairs) {
+      std::vector<std::array<uint8_t, 64>> inputs(pairs.size());
+      std::vector<const uint8_t*> data(pairs.size());
+      std::vector<size_t> sizes(pairs.size(), 64);
+      for (size_t i = 0; i < pairs.size(); i++) {
+        intx::be::unsafe::store(inputs[i].data(), pairs[i].first);
+        intx::be::unsafe::store(inputs[i].data() + 32, pairs[i].second);
+        data[i] = inputs[i].data();
+      }
+
+      std::vector<ethash::hash256> results(pairs.size());
+      ethash::keccak256_batch(results.data(), data.data(), sizes.data(), pairs.size());
+
+      std::vector<uint256_t> hashes;
+      hashes.reserve(pairs.size());
+      for (const ethash::hash256& result : results) hashes.push_back(intx::be::load<uint256_t>(result.bytes));
+      return hashes;
+    }
+
     static bytes_t keccak256(const bytes_t& bytes) {
       ethash::hash256 result = ethash::keccak256(bytes.data(), bytes.size());
       bytes_t hashBytes(&result.bytes[0], &result.bytes[32]);
@@ -36,6 +58,16 @@ class Hash {
       return intx::be::load<uint256_t>(result.bytes);
     }
 
+    static bytes_t sha256(const bytes_t& bytes) {
+      std::array<uint8_t, 32> hash = Sha256::hash(bytes.data(), bytes.size());
+      return bytes_t(hash.begin(), hash.end());
+    }
+
+    static bytes_t ripemd160(const bytes_t& bytes) {
+      std::array<uint8_t, 20> hash = Ripemd160::hash(bytes.data(), bytes.size());
+      return bytes_t(hash.begin(), hash.end());
+    }
+
     static bytes_t keccak256(const std::array<uint8_t, 33>& bytes) {
       ethash::hash256 result = ethash::keccak256(bytes.data(), bytes.size());
       bytes_t hashBytes(&result.bytes[0], &result.bytes[32]);
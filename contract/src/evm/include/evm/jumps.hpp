@@ -1,22 +1,38 @@
 #pragma once
 #include <memory>
+#include <cstring>
 #include <evm/types.h>
 #include <evm/instruction.hpp>
 #include <evm/opcode.h>
 
 class Jumps {
   public:
-    static jump_set_t findDestinations(std::shared_ptr<bytes_t> bytes) {
-      jump_set_t jumps = jump_set_t();
+    /*
+      Packs every valid JUMPDEST position of the code into a bitmap, one bit per code byte.
+      Runs of eight bytes that contain neither a PUSH nor a JUMPDEST are skipped in a single step.
+    */
+    static jump_map_t findDestinations(std::shared_ptr<bytes_t> bytes) {
+      const uint8_t* code = bytes->data();
+      const uint64_t size = bytes->size();
+      jump_map_t jumps((size + 63) / 64, 0);
 
-      int position = 0;
+      uint64_t position = 0;
 
-      while (position < bytes->size()) {
-        uint8_t index = bytes->at(position);
+      while (position < size) {
+        if (position + 8 <= size) {
+          uint64_t word;
+          std::memcpy(&word, code + position, 8);
+          if (!hasPushOrJumpdest(word)) {
+            position += 8;
+            continue;
+          }
+        }
+
+        uint8_t index = code[position];
         instruct_t instruction = Instruction::values[index];
 
         if (instruction.opcode == Opcode::JUMPDEST) {
-          jumps.insert(position);
+          jumps[position >> 6] |= uint64_t(1) << (position & 63);
         } else {
           position += Instruction::pushBytes(instruction);
         }
@@ -27,8 +43,38 @@ class Jumps {
       return jumps;
     }
 
-    static uint64_t verifyJump(uint64_t position, const jump_set_t& validDestinations) {
-      if (validDestinations.find(position) != validDestinations.end()) return position;
+    static uint64_t verifyJump(uint64_t position, const jump_map_t& validDestinations) {
+      if (isDestination(position, validDestinations)) return position;
       return INVALID_ARGUMENT;
     }
-};
\ No newline at end of file
+
+    static bool isDestination(uint64_t position, const jump_map_t& validDestinations) {
+      uint64_t word = position >> 6;
+      if (word >= validDestinations.size()) return false;
+      return (validDestinations[word] >> (position & 63)) & 1;
+    }
+
+    static std::vector<uint64_t> destinations(const jump_map_t& validDestinations) {
+      std::vector<uint64_t> positions;
+      for (uint64_t word = 0; word < validDestinations.size(); word++) {
+        for (uint64_t bit = 0; bit < 64; bit++) {
+          if ((validDestinations[word] >> bit) & 1) positions.push_back((word << 6) + bit);
+        }
+      }
+      return positions;
+    }
+
+  private:
+    static constexpr uint64_t LOW_BITS = 0x0101010101010101;
+    static constexpr uint64_t HIGH_BITS = 0x8080808080808080;
+
+    static bool hasZeroByte(uint64_t word) {
+      return ((word - LOW_BITS) & ~word & HIGH_BITS) != 0;
+    }
+
+    // PUSH1..PUSH32 are exactly the bytes matching 011xxxxx
+    static bool hasPushOrJumpdest(uint64_t word) {
+      return hasZeroByte(word ^ (LOW_BITS * Opcode::JUMPDEST))
+        || hasZeroByte((word & (LOW_BITS * 0xE0)) ^ (LOW_BITS * 0x60));
+    }
+};
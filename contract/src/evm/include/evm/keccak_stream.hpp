@@ -0,0 +1,71 @@
+#pragma once
+#include <cstring>
+#include <algorithm>
+#include <keccak/keccak.hpp>
+#include <keccak/keccakf1600.h>
+#include <evm/types.h>
+
+/*
+  Keccak-256 over input that arrives in pieces, so a message spread over several buffers can be
+  hashed without first being copied into one. Produces the same digest as ethash::keccak256.
+*/
+class KeccakStream {
+  public:
+    void update(const uint8_t* data, size_t size) {
+      if (buffered > 0) {
+        size_t take = std::min(size, RATE - buffered);
+        std::memcpy(buffer + buffered, data, take);
+        buffered += take;
+        data += take;
+        size -= take;
+        if (buffered < RATE) return;
+        absorb(buffer);
+        buffered = 0;
+      }
+
+      while (size >= RATE) {
+        absorb(data);
+        data += RATE;
+        size -= RATE;
+      }
+
+      std::memcpy(buffer, data, size);
+      buffered = size;
+    }
+
+    void update(uint8_t byte) {
+      update(&byte, 1);
+    }
+
+    void update(const bytes_t& bytes) {
+      update(bytes.data(), bytes.size());
+    }
+
+    ethash::hash256 finalize() {
+      std::memset(buffer + buffered, 0, RATE - buffered);
+      buffer[buffered] ^= 0x01;
+      buffer[RATE - 1] ^= 0x80;
+      absorb(buffer);
+      buffered = 0;
+
+      ethash::hash256 hash;
+      for (size_t i = 0; i < 4; i++) hash.word64s[i] = state[i];
+      return hash;
+    }
+
+  private:
+    static const size_t RATE = 136;
+
+    uint64_t state[25] = {0};
+    uint8_t buffer[RATE];
+    size_t buffered = 0;
+
+    void absorb(const uint8_t* block) {
+      for (size_t i = 0; i < RATE / 8; i++) {
+        uint64_t word;
+        std::memcpy(&word, block + i * 8, sizeof(word));
+        state[i] ^= word;
+      }
+      Keccakf1600::keccakf1600(state);
+    }
+};
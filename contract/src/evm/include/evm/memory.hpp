@@ -32,6 +32,12 @@ class Memory {
       memorySize = 0;
     };
 
+    // drops the contents but keeps whatever capacity earlier frames grew the buffer to
+    void reset() {
+      memory.clear();
+      memorySize = 0;
+    }
+
     void expand(uint64_t size) {
       if (size > memorySize) {
         resize(size);
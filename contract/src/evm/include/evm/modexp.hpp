@@ -0,0 +1,271 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <evm/types.h>
+
+typedef std::vector<uint64_t> limbs_t;
+
+/*
+  base^exponent mod modulus for unsigned integers of any width, for the 0x05 precompile. Values
+  are little-endian vectors of 64-bit limbs. Odd moduli (RSA, the prime fields zk verifiers
+  work in) multiply in Montgomery form, so the exponentiation itself never divides; an even
+  modulus reduces each product by long division instead. Both walk the exponent with a sliding
+  window over a table of odd powers.
+*/
+class ModExp {
+  public:
+    // big-endian in and out; the result is as wide as the modulus
+    static bytes_t power(const bytes_t& base, const bytes_t& exponent, const bytes_t& modulus) {
+      limbs_t m = fromBytes(modulus);
+      if (m.empty()) return bytes_t(modulus.size(), 0);
+
+      size_t n = m.size();
+      limbs_t b = remainder(fromBytes(base), m);
+      limbs_t one(1, 1);
+      limbs_t result;
+
+      if ((m[0] & 1) != 0) {
+        uint64_t mInverse = negativeInverse(m[0]);
+        auto multiply = [&m, mInverse](const limbs_t& x, const limbs_t& y) {
+          return montgomeryMultiply(x, y, m, mInverse);
+        };
+
+        // x R mod m with R = 2^(64 n), which is x shifted up by n limbs
+        limbs_t shiftedBase(n, 0);
+        shiftedBase.insert(shiftedBase.end(), b.begin(), b.end());
+        limbs_t shiftedOne(n, 0);
+        shiftedOne.push_back(1);
+
+        limbs_t x = slidingWindow(exponent, remainder(shiftedBase, m), remainder(shiftedOne, m), multiply);
+        // multiplying by 1 divides by R, leaving Montgomery form
+        one.resize(n, 0);
+        result = multiply(x, one);
+      } else {
+        auto multiply = [&m](const limbs_t& x, const limbs_t& y) {
+          return remainder(product(x, y), m);
+        };
+        result = slidingWindow(exponent, b, remainder(one, m), multiply);
+      }
+
+      return toBytes(result, modulus.size());
+    }
+
+    static size_t bitLength(const bytes_t& value) {
+      for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] != 0) return (value.size() - i - 1) * 8 + 32 - intx::clz(static_cast<uint32_t>(value[i]));
+      }
+      return 0;
+    }
+
+  private:
+    static bool bit(const bytes_t& value, size_t index) {
+      return ((value[value.size() - 1 - index / 8] >> (index % 8)) & 1) != 0;
+    }
+
+    template <typename Multiply>
+    static limbs_t slidingWindow(const bytes_t& exponent, const limbs_t& base, const limbs_t& one, Multiply multiply) {
+      size_t bits = bitLength(exponent);
+      if (bits == 0) return one;
+
+      size_t width = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : 1;
+
+      // base^1, base^3, ..., base^(2^width - 1)
+      std::vector<limbs_t> oddPowers(size_t(1) << (width - 1));
+      oddPowers[0] = base;
+      if (width > 1) {
+        limbs_t square = multiply(base, base);
+        for (size_t i = 1; i < oddPowers.size(); i++) oddPowers[i] = multiply(oddPowers[i - 1], square);
+      }
+
+      // empty until the first window, which saves squaring one
+      limbs_t result;
+      size_t i = bits;
+      while (i > 0) {
+        if (!bit(exponent, i - 1)) {
+          result = multiply(result, result);
+          i--;
+          continue;
+        }
+
+        // the longest run of at most width bits from bit i - 1 down that ends in a one
+        size_t length = std::min(width, i);
+        while (!bit(exponent, i - length)) length--;
+        size_t value = 0;
+        for (size_t k = 1; k <= length; k++) value = (value << 1) | (bit(exponent, i - k) ? 1 : 0);
+
+        if (result.empty()) {
+          result = oddPowers[value >> 1];
+        } else {
+          for (size_t k = 0; k < length; k++) result = multiply(result, result);
+          result = multiply(result, oddPowers[value >> 1]);
+        }
+        i -= length;
+      }
+      return result;
+    }
+
+    // -m^-1 mod 2^64 by Newton's iteration; an odd m is its own inverse mod 8
+    static uint64_t negativeInverse(uint64_t m) {
+      uint64_t inverse = m;
+      for (size_t i = 0; i < 5; i++) inverse *= 2 - m * inverse;
+      return 0 - inverse;
+    }
+
+    // x y / R mod m for x, y < m, interleaving the multiplication and the reduction (CIOS)
+    static limbs_t montgomeryMultiply(const limbs_t& x, const limbs_t& y, const limbs_t& m, uint64_t mInverse) {
+      size_t n = m.size();
+      limbs_t t(n + 2, 0);
+      for (size_t i = 0; i < n; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < n; j++) {
+          intx::uint128 sum = intx::umul(x[j], y[i]) + t[j] + carry;
+          t[j] = sum.lo;
+          carry = sum.hi;
+        }
+        intx::uint128 top = intx::uint128(t[n]) + carry;
+        t[n] = top.lo;
+        t[n + 1] = top.hi;
+
+        // adding u m clears the lowest limb, which is then shifted out
+        uint64_t u = t[0] * mInverse;
+        intx::uint128 sum = intx::umul(u, m[0]) + t[0];
+        carry = sum.hi;
+        for (size_t j = 1; j < n; j++) {
+          sum = intx::umul(u, m[j]) + t[j] + carry;
+          t[j - 1] = sum.lo;
+          carry = sum.hi;
+        }
+        top = intx::uint128(t[n]) + carry;
+        t[n - 1] = top.lo;
+        t[n] = t[n + 1] + top.hi;
+      }
+
+      // t < 2m here
+      t.resize(n + 1);
+      if (t[n] != 0 || !less(t, m)) subtract(t, m);
+      t.resize(n);
+      return t;
+    }
+
+    static limbs_t product(const limbs_t& x, const limbs_t& y) {
+      limbs_t result(x.size() + y.size(), 0);
+      for (size_t i = 0; i < x.size(); i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < y.size(); j++) {
+          intx::uint128 sum = intx::umul(x[i], y[j]) + result[i + j] + carry;
+          result[i + j] = sum.lo;
+          carry = sum.hi;
+        }
+        result[i + y.size()] = carry;
+      }
+      return result;
+    }
+
+    /*
+      x mod m as exactly m.size() limbs, for m without leading zero limbs. Long division in base
+      2^64 (Knuth's algorithm D) with the divisor shifted so its top bit is set, which keeps each
+      estimated quotient limb at most two too large; only the remainder is kept.
+    */
+    static limbs_t remainder(const limbs_t& x, const limbs_t& m) {
+      size_t n = m.size();
+      size_t size = x.size();
+      while (size > 0 && x[size - 1] == 0) size--;
+      if (size < n) {
+        limbs_t result(x.begin(), x.begin() + size);
+        result.resize(n, 0);
+        return result;
+      }
+
+      unsigned shift = intx::clz(m[n - 1]);
+      limbs_t v = shiftLeft(m.begin(), m.end(), shift);
+      limbs_t u = shiftLeft(x.begin(), x.begin() + size, shift);
+      u.push_back(size > 0 && shift > 0 ? x[size - 1] >> (64 - shift) : 0);
+
+      uint64_t top = v[n - 1];
+      uint64_t reciprocal = intx::reciprocal_2by1(top);
+      for (size_t j = u.size() - n; j > 0; j--) {
+        uint64_t* window = &u[j - 1];
+        uint64_t estimate = window[n] >= top
+          ? ~uint64_t(0)
+          : intx::udivrem_2by1(intx::uint128(window[n], window[n - 1]), top, reciprocal).quot;
+
+        uint64_t carry = 0;
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < n; i++) {
+          intx::uint128 scaled = intx::umul(estimate, v[i]) + carry;
+          carry = scaled.hi;
+          intx::uint128 difference = intx::uint128(window[i]) - scaled.lo - borrow;
+          window[i] = difference.lo;
+          borrow = difference.hi != 0 ? 1 : 0;
+        }
+        intx::uint128 difference = intx::uint128(window[n]) - carry - borrow;
+        window[n] = difference.lo;
+
+        // the estimate was too large: add the divisor back until the window is positive again
+        bool negative = difference.hi != 0;
+        while (negative) {
+          uint64_t addCarry = 0;
+          for (size_t i = 0; i < n; i++) {
+            intx::uint128 sum = intx::uint128(window[i]) + v[i] + addCarry;
+            window[i] = sum.lo;
+            addCarry = sum.hi;
+          }
+          intx::uint128 sum = intx::uint128(window[n]) + addCarry;
+          window[n] = sum.lo;
+          negative = sum.hi == 0;
+        }
+      }
+
+      limbs_t result(n, 0);
+      for (size_t i = 0; i < n; i++) {
+        result[i] = shift == 0 ? u[i] : (u[i] >> shift) | (u[i + 1] << (64 - shift));
+      }
+      return result;
+    }
+
+    static limbs_t shiftLeft(limbs_t::const_iterator begin, limbs_t::const_iterator end, unsigned shift) {
+      limbs_t result(begin, end);
+      if (shift == 0) return result;
+      for (size_t i = result.size(); i > 0; i--) {
+        result[i - 1] <<= shift;
+        if (i > 1) result[i - 1] |= *(begin + (i - 2)) >> (64 - shift);
+      }
+      return result;
+    }
+
+    // compares the low m.size() limbs of x with m
+    static bool less(const limbs_t& x, const limbs_t& m) {
+      for (size_t i = m.size(); i > 0; i--) {
+        if (x[i - 1] != m[i - 1]) return x[i - 1] < m[i - 1];
+      }
+      return false;
+    }
+
+    static void subtract(limbs_t& x, const limbs_t& m) {
+      uint64_t borrow = 0;
+      for (size_t i = 0; i < m.size(); i++) {
+        intx::uint128 difference = intx::uint128(x[i]) - m[i] - borrow;
+        x[i] = difference.lo;
+        borrow = difference.hi != 0 ? 1 : 0;
+      }
+    }
+
+    // without leading zero limbs, so zero is empty
+    static limbs_t fromBytes(const bytes_t& bytes) {
+      limbs_t limbs((bytes.size() + 7) / 8, 0);
+      for (size_t i = 0; i < bytes.size(); i++) {
+        size_t position = bytes.size() - 1 - i;
+        limbs[i / 8] |= static_cast<uint64_t>(bytes[position]) << (8 * (i % 8));
+      }
+      while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+      return limbs;
+    }
+
+    static bytes_t toBytes(const limbs_t& limbs, size_t size) {
+      bytes_t bytes(size, 0);
+      for (size_t i = 0; i < size && i / 8 < limbs.size(); i++) {
+        bytes[size - 1 - i] = static_cast<uint8_t>(limbs[i / 8] >> (8 * (i % 8)));
+      }
+      return bytes;
+    }
+};
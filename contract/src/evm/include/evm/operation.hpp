@@ -10,17 +10,13 @@
 #include <evm/context.hpp>
 #include <evm/pending_state.hpp>
 #include <evm/external.h>
+#include <evm/execution_state.hpp>
 
 class Operation { 
   typedef instruction_result_t (Operation::*operation_t)(
     gas_t gas,
-    instruct_t instruction, 
-    std::shared_ptr<Context> context,
-    std::shared_ptr<ByteReader> reader,
-    std::shared_ptr<PendingState> pendingState,
-    std::shared_ptr<External> external,
-    std::shared_ptr<Memory> memory, 
-    std::shared_ptr<StackMachine> stack
+    instruct_t instruction,
+    ExecutionState& state
   );
   public: 
     Operation() {
@@ -163,85 +159,60 @@ class Operation {
 
     instruction_result_t stop(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
       return std::make_pair(InstructionResult::STOP_EXEC, 0);
     }
 
     instruction_result_t add(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t result = stack->peek(0) + stack->peek(1);
-      stack->pop(2);
-      stack->push(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t result = state.stack.peek(0) + state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t mul(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t result = stack->peek(0) * stack->peek(1);
-      stack->pop(2);
-      stack->push(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t result = state.stack.peek(0) * state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t sub(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t result = stack->peek(0) - stack->peek(1);
-      stack->pop(2);
-      stack->push(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t result = state.stack.peek(0) - state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t div(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
 
       if (b == 0) {
-        stack->pop(2);
-        stack->push(uint256_t(0));
+        state.stack.pop(2);
+        state.stack.push(uint256_t(0));
       } else {
         uint256_t result = a / b;
-        stack->pop(2);
-        stack->push(result);
+        state.stack.pop(2);
+        state.stack.push(result);
       }
 
       return std::make_pair(InstructionResult::OK, 0);
@@ -249,392 +220,287 @@ class Operation {
 
     instruction_result_t sdiv(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
       uint256_t result = b != 0 ? intx::sdivrem(a, b).quot : 0;
-      stack->pop(2);
-      stack->push(b != 0 ? intx::sdivrem(a, b).quot : 0);
+      state.stack.pop(2);
+      state.stack.push(b != 0 ? intx::sdivrem(a, b).quot : 0);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t mod(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
       if (b == 0) {
-        stack->pop(2);
-        stack->push(uint256_t(0));
+        state.stack.pop(2);
+        state.stack.push(uint256_t(0));
       } else {
         uint256_t result = a % b;
-        stack->pop(2);
-        stack->push(result);
+        state.stack.pop(2);
+        state.stack.push(result);
       }
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t smod(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
       uint256_t result = b != 0 ? intx::sdivrem(a, b).rem : 0;
-      stack->pop(2);
-      stack->push(result);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t addmod(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
-      uint256_t c = stack->peek(2);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
+      uint256_t c = state.stack.peek(2);
       uint256_t result = c != 0 ? intx::addmod(a, b, c) : 0;
-      stack->pop(3);
-      stack->push(result);
+      state.stack.pop(3);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t mulmod(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
-      uint256_t c = stack->peek(2);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
+      uint256_t c = state.stack.peek(2);
       uint256_t result = c != 0 ? intx::mulmod(a, b, c) : 0;
-      stack->pop(3);
-      stack->push(result);
+      state.stack.pop(3);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t exp(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
       uint256_t result = intx::exp(a, b);
-      stack->pop(2);
-      stack->push(result);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t signextend(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t ext = stack->peek(0);
-      uint256_t x = stack->peek(1);
-      stack->pop(1);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t ext = state.stack.peek(0);
+      uint256_t x = state.stack.peek(1);
+      state.stack.pop(1);
       if (ext < 31) {
-        stack->pop(1);
+        state.stack.pop(1);
         auto sign_bit = static_cast<int>(ext) * 8 + 7;
         auto sign_mask = uint256_t{1} << sign_bit;
         auto value_mask = sign_mask - 1;
         auto is_neg = (x & sign_mask) != 0;
-        stack->push(is_neg ? x | ~value_mask : x & value_mask);
+        state.stack.push(is_neg ? x | ~value_mask : x & value_mask);
       }
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t lt(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      bool result = stack->peek(0) < stack->peek(1);
-      stack->pop(2);
-      stack->pushBool(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      bool result = state.stack.peek(0) < state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.pushBool(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t gt(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      bool result = stack->peek(0) > stack->peek(1);
-      stack->pop(2);
-      stack->pushBool(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      bool result = state.stack.peek(0) > state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.pushBool(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t slt(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
-      stack->pop(2);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
+      state.stack.pop(2);
 
       bool x_neg = static_cast<bool>(a >> 255);
       bool y_neg = static_cast<bool>(b >> 255);
 
-      stack->pushBool((x_neg ^ y_neg) ? x_neg : a < b);
+      state.stack.pushBool((x_neg ^ y_neg) ? x_neg : a < b);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t sgt(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
-      stack->pop(2);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
+      state.stack.pop(2);
 
       bool x_neg = static_cast<bool>(a >> 255);
       bool y_neg = static_cast<bool>(b >> 255);
 
-      stack->pushBool((x_neg ^ y_neg) ? y_neg : a < b);
+      state.stack.pushBool((x_neg ^ y_neg) ? y_neg : a < b);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t eq(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      bool result = stack->peek(0) == stack->peek(1);
-      stack->pop(2);
-      stack->pushBool(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      bool result = state.stack.peek(0) == state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.pushBool(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t iszero(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      bool result = stack->peek(0) == UINT256_ZERO;
-      stack->pop(1);
-      stack->pushBool(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      bool result = state.stack.peek(0) == UINT256_ZERO;
+      state.stack.pop(1);
+      state.stack.pushBool(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t _and(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t result = stack->peek(0) & stack->peek(1);
-      stack->pop(2);
-      stack->push(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t result = state.stack.peek(0) & state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t _or(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t result = stack->peek(0) | stack->peek(1);
-      stack->pop(2);
-      stack->push(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t result = state.stack.peek(0) | state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t _xor(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t result = stack->peek(0) ^ stack->peek(1);
-      stack->pop(2);
-      stack->push(result);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t result = state.stack.peek(0) ^ state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(result);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t _not(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t item = stack->peek(0);
-      stack->pop(1);
-      stack->push(~item);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t item = state.stack.peek(0);
+      state.stack.pop(1);
+      state.stack.push(~item);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t _byte(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t word = stack->peek(0);
-      uint256_t val = stack->peek(1);
-      stack->pop(2);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t word = state.stack.peek(0);
+      uint256_t val = state.stack.peek(1);
+      state.stack.pop(2);
       if (word < UINT256_32) {
         uint64_t word64 = Overflow::uint256Cast(word).first;
         uint256_t result = val >> (8 * (31 - word64)) & UINT256_FF;
-        stack->push(result);
+        state.stack.push(result);
       } else {
-        stack->push(UINT256_ZERO);
+        state.stack.push(UINT256_ZERO);
       }
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t shl(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
-      stack->pop(2);
-      stack->push(b <<= a);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(b <<= a);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t shr(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
-      stack->pop(2);
-      stack->push(b >>= a);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
+      state.stack.pop(2);
+      state.stack.push(b >>= a);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t sar(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t a = stack->peek(0);
-      uint256_t b = stack->peek(1);
+      uint256_t a = state.stack.peek(0);
+      uint256_t b = state.stack.peek(1);
       
       if ((b & (uint256_t{1} << 255)) == 0) {
-        stack->push(b >>= a);
+        state.stack.push(b >>= a);
       } else {
         constexpr auto allones = ~uint256_t{};
         if (a >= 256) {
-          stack->push(allones);
+          state.stack.push(allones);
         } else {
           const auto shift = static_cast<unsigned>(a);
-          stack->push((b >> shift) | (allones << (256 - shift)));
+          state.stack.push((b >> shift) | (allones << (256 - shift)));
         }
       }
       return std::make_pair(InstructionResult::OK, 0);
@@ -642,331 +508,226 @@ class Operation {
 
     instruction_result_t sha3(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint64_t offset = Overflow::uint256Cast(stack->peek(0)).first;
-      uint64_t size = Overflow::uint256Cast(stack->peek(1)).first;
-      stack->pop(2);
-      stack->push(memory->hashSlice(offset, size));
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint64_t offset = Overflow::uint256Cast(state.stack.peek(0)).first;
+      uint64_t size = Overflow::uint256Cast(state.stack.peek(1)).first;
+      state.stack.pop(2);
+      state.stack.push(state.memory.hashSlice(offset, size));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t address(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->address);
+      state.stack.push(state.context.address);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t origin(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->origin);
+      state.stack.push(state.context.origin);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t caller(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->sender);
+      state.stack.push(state.context.sender);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t callvalue(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->value);
+      state.stack.push(state.context.value);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t calldataload(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t index = stack->peek(0);
-      stack->pop(1);
-      if (context->data->size() < index) {
-        stack->push(UINT256_ZERO);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t index = state.stack.peek(0);
+      state.stack.pop(1);
+      if (state.context.data->size() < index) {
+        state.stack.push(UINT256_ZERO);
       } else {
         size_t begin = Overflow::uint256Cast(index).first;
-        size_t end = std::min(begin + WORD_SIZE, context->data->size());
+        size_t end = std::min(begin + WORD_SIZE, state.context.data->size());
         uint8_t data[WORD_SIZE] = {};
         for (size_t i = begin; i < end; i++)
-          data[i - begin] = context->data->at(i);
+          data[i - begin] = state.context.data->at(i);
         uint256_t word = intx::be::load<uint256_t>(data);
-        stack->push(word);
+        state.stack.push(word);
       }
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t calldatasize(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(uint256_t(context->data->size()));
+      state.stack.push(uint256_t(state.context.data->size()));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t calldatacopy(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t destOffset = stack->peek(0);
-      uint256_t sourceOffset = stack->peek(1);
-      uint256_t sizeItem = stack->peek(2);
+      uint256_t destOffset = state.stack.peek(0);
+      uint256_t sourceOffset = state.stack.peek(1);
+      uint256_t sizeItem = state.stack.peek(2);
 
-      memory->copyData(
+      state.memory.copyData(
         Overflow::uint256Cast(destOffset).first, 
         Overflow::uint256Cast(sourceOffset).first, 
         Overflow::uint256Cast(sizeItem).first, 
-        context->data
+        state.context.data
       );
-      stack->pop(3);
+      state.stack.pop(3);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t gasprice(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(uint256_t(context->gasPrice));
+      state.stack.push(uint256_t(state.context.gasPrice));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t blockhash(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->pop(1);
-      stack->push(context->blockHash);
+      state.stack.pop(1);
+      state.stack.push(state.context.blockHash);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t coinbase(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->coinbase);
+      state.stack.push(state.context.coinbase);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t timestamp(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->timestamp);
+      state.stack.push(state.context.timestamp);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t number(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->blockNumber);
+      state.stack.push(state.context.blockNumber);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t difficulty(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->difficulty);
+      state.stack.push(state.context.difficulty);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t gaslimit(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->gasLimit);
+      state.stack.push(state.context.gasLimit);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t chainid(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(context->chainId);
+      state.stack.push(state.context.chainId);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t pop(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->pop(1);
+      state.stack.pop(1);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t mload(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t offset = stack->peek(0);
-      uint256_t word = memory->read(Overflow::uint256Cast(offset).first);
-      stack->pop(1);
-      stack->push(word);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t offset = state.stack.peek(0);
+      uint256_t word = state.memory.read(Overflow::uint256Cast(offset).first);
+      state.stack.pop(1);
+      state.stack.push(word);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t mstore(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t offset = stack->peek(0);
-      uint256_t word = stack->peek(1);
-      memory->write(Overflow::uint256Cast(offset).first, word);
-      stack->pop(2);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t offset = state.stack.peek(0);
+      uint256_t word = state.stack.peek(1);
+      state.memory.write(Overflow::uint256Cast(offset).first, word);
+      state.stack.pop(2);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t mstore8(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t offset = stack->peek(0);
-      uint256_t byte = stack->peek(1);
-      memory->writeByte(Overflow::uint256Cast(offset).first, byte);
-      stack->pop(2);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t offset = state.stack.peek(0);
+      uint256_t byte = state.stack.peek(1);
+      state.memory.writeByte(Overflow::uint256Cast(offset).first, byte);
+      state.stack.pop(2);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t jump(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t position = stack->peek(0);
-      stack->pop(1);
+      uint256_t position = state.stack.peek(0);
+      state.stack.pop(1);
       return std::make_pair(
         InstructionResult::JUMP_POSITION,
         Overflow::uint256Cast(position).first
@@ -975,171 +736,126 @@ class Operation {
 
     instruction_result_t jumpi(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t condition = stack->peek(1);
+      uint256_t condition = state.stack.peek(1);
       if (condition == UINT256_ONE) {
-        uint256_t position = stack->peek(0);
+        uint256_t position = state.stack.peek(0);
         uint64_t positionValue = Overflow::uint256Cast(position).first;
-        stack->pop(2);
+        state.stack.pop(2);
         return std::make_pair(
           InstructionResult::JUMP_POSITION, 
           positionValue
         );
       }
-      stack->pop(2);
+      state.stack.pop(2);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t msize(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      size_t length = memory->length();
-      stack->push(uint256_t(length));
+      size_t length = state.memory.length();
+      state.stack.push(uint256_t(length));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t dup(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(stack->peek(Instruction::dupPosition(instruction)));
+      state.stack.push(state.stack.peek(Instruction::dupPosition(instruction)));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t swap(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->swapWithTop(Instruction::swapPosition(instruction));
+      state.stack.swapWithTop(Instruction::swapPosition(instruction));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t extcodesize(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t address = stack->peek(0);
-      stack->pop(1);
-      size_t codeSize = external->code(address, pendingState).size();
-      stack->push(uint256_t(codeSize));
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t address = state.stack.peek(0);
+      state.stack.pop(1);
+      uint64_t codeSize = state.external->codeSize(address, state.pendingState);
+      state.stack.push(uint256_t(codeSize));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t extcodecopy(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t address = stack->peek(0);
-      uint256_t destOffset = stack->peek(1);
-      uint256_t sourceOffset = stack->peek(2);
-      uint256_t sizeItem = stack->peek(3);
+      uint256_t address = state.stack.peek(0);
+      uint256_t destOffset = state.stack.peek(1);
+      uint256_t sourceOffset = state.stack.peek(2);
+      uint256_t sizeItem = state.stack.peek(3);
 
-      memory->copyData(
+      state.memory.copyData(
         Overflow::uint256Cast(destOffset).first, 
         Overflow::uint256Cast(sourceOffset).first, 
         Overflow::uint256Cast(sizeItem).first, 
-        external->code(address, pendingState)
+        state.external->code(address, state.pendingState)
       );
-      stack->pop(4);
+      state.stack.pop(4);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t selfbalance(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(external->balance(context->address, pendingState));
+      state.stack.push(state.external->balance(state.context.address, state.pendingState));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t log(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
       uint8_t numberOfTopics = Instruction::logTopics(instruction);
-      uint64_t offset = Overflow::uint256Cast(stack->peek(0)).first;
-      uint64_t size = Overflow::uint256Cast(stack->peek(1)).first;
+      uint64_t offset = Overflow::uint256Cast(state.stack.peek(0)).first;
+      uint64_t size = Overflow::uint256Cast(state.stack.peek(1)).first;
 
       std::vector<uint256_t> topics;
       for (int i = 2; i < 2 + numberOfTopics; i++) {
-        topics.push_back(stack->peek(i));
+        topics.push_back(state.stack.peek(i));
       }
 
-      stack->pop(2 + numberOfTopics);
+      state.stack.pop(2 + numberOfTopics);
 
-      if (context->isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
+      if (state.context.isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
 
-      pendingState->log(topics, memory->readSlice(offset, size));
+      state.pendingState->log(topics, state.memory.readSlice(offset, size));
       
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t selfdestruct(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t refundAddress = stack->peek(0);
-      stack->pop(1);
+      uint256_t refundAddress = state.stack.peek(0);
+      state.stack.pop(1);
 
-      if (context->isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
+      if (state.context.isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
 
-      emplace_t result = external->selfdestruct(context->codeAddress, refundAddress, pendingState);
+      emplace_t result = state.external->selfdestruct(state.context.codeAddress, refundAddress, state.pendingState);
 
       switch (result.first) {
         case EmplaceResult::EMPLACE_ADDRESS_NOT_FOUND:
@@ -1153,165 +869,115 @@ class Operation {
 
     instruction_result_t codesize(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(uint256_t(context->code->size()));
+      state.stack.push(uint256_t(state.context.code->size()));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t codecopy(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t destOffset = stack->peek(0);
-      uint256_t sourceOffset = stack->peek(1);
-      uint256_t sizeItem = stack->peek(2);
+      uint256_t destOffset = state.stack.peek(0);
+      uint256_t sourceOffset = state.stack.peek(1);
+      uint256_t sizeItem = state.stack.peek(2);
 
-      memory->copyData(
+      state.memory.copyData(
         Overflow::uint256Cast(destOffset).first, 
         Overflow::uint256Cast(sourceOffset).first, 
         Overflow::uint256Cast(sizeItem).first, 
-        context->code
+        state.context.code
       );
-      stack->pop(3);
+      state.stack.pop(3);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t pc(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(uint256_t(reader->pc()));
+      state.stack.push(uint256_t(state.reader.pc()));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t push(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      stack->push(reader->read(Instruction::pushBytes(instruction), context->code));
+      state.stack.push(state.reader.read(Instruction::pushBytes(instruction), state.context.code));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t jumpdest(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t balance(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t balance = external->balance(stack->peek(0), pendingState);
-      stack->pop(1);
-      stack->push(balance);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t balance = state.external->balance(state.stack.peek(0), state.pendingState);
+      state.stack.pop(1);
+      state.stack.push(balance);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t sload(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t key = stack->peek(0);
-      uint256_t word =  pendingState->getState(key, context->codeAddress, [external, key, context] () {
-        return external->storageAt(key, context->codeAddress);
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t key = state.stack.peek(0);
+      uint256_t word =  state.pendingState->getState(key, state.context.codeAddress, [&state, key] () {
+        return state.external->storageAt(key, state.context.codeAddress);
       });
-      stack->pop(1);
-      stack->push(word);
+      state.stack.pop(1);
+      state.stack.push(word);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t sstore(
       gas_t gas,
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      instruct_t instruction,
+      ExecutionState& state
     ) {
-      uint256_t key = stack->peek(0);
-      uint256_t value = stack->peek(1);  
-      stack->pop(2);
+      uint256_t key = state.stack.peek(0);
+      uint256_t value = state.stack.peek(1);  
+      state.stack.pop(2);
 
-      if (context->isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
+      if (state.context.isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
 
-      pendingState->putState(key, value, context->codeAddress);
+      state.pendingState->putState(key, value, state.context.codeAddress);
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t gas(
-      gas_t gas,      
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      stack->push(uint256_t(gas));
+      gas_t gas,
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      state.stack.push(uint256_t(gas));
       return std::make_pair(InstructionResult::OK, 0);
     }
 
     instruction_result_t _return(
-      gas_t gas,      
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t initOff = stack->peek(0);
-      uint256_t initSize = stack->peek(1);
-      stack->pop(2);
+      gas_t gas,
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t initOff = state.stack.peek(0);
+      uint256_t initSize = state.stack.peek(1);
+      state.stack.pop(2);
 
       StopExecutionResult result {
         gas,
@@ -1327,18 +993,13 @@ class Operation {
     }
 
     instruction_result_t _revert(
-      gas_t gas,      
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
-    ) {
-      uint256_t initOff = stack->peek(0);
-      uint256_t initSize = stack->peek(1);
-      stack->pop(2);
+      gas_t gas,
+      instruct_t instruction,
+      ExecutionState& state
+    ) {
+      uint256_t initOff = state.stack.peek(0);
+      uint256_t initSize = state.stack.peek(1);
+      state.stack.pop(2);
 
       StopExecutionResult result {
         gas,
@@ -1354,19 +1015,13 @@ class Operation {
     }
 
     instruction_result_t extcodehash(
-      gas_t gas,      
-      instruct_t instruction, 
-      std::shared_ptr<Context> context, 
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external,
-      std::shared_ptr<Memory> memory, 
-      std::shared_ptr<StackMachine> stack
+      gas_t gas,
+      instruct_t instruction,
+      ExecutionState& state
     ) {  
-      uint256_t address = stack->peek(0);
-      stack->pop(1);
-      bytes_t codeBytes = external->code(address, pendingState);
-      stack->push(Hash::keccak256Word(codeBytes));
+      uint256_t address = state.stack.peek(0);
+      state.stack.pop(1);
+      state.stack.push(state.external->codeHash(address, state.pendingState));
       return std::make_pair(InstructionResult::OK, 0);
     }
 };
\ No newline at end of file
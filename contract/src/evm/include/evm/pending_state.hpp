@@ -1,10 +1,13 @@
 #pragma once
 #include <iterator>
 #include <numeric>
+#include <unordered_map>
 #include <evm/types.h>
 #include <evm/overflow.hpp>
 #include <evm/hex.hpp>
 #include <evm/big_int.hpp>
+#include <evm/code_analysis.hpp>
+#include <evm/frame_arena.hpp>
 
 struct Log {
   uint64_t stackDepth;
@@ -65,11 +68,80 @@ struct AddressChange {
 typedef AddressChange self_destruct_t;
 typedef AddressChange contract_creation_t;
 
-struct {
-  bool operator()(account_state_t a, account_state_t b) const {   
-    return a.nonce < b.nonce;
-  }   
-} nonceOrder;
+struct SlotKey {
+  uint256_t codeAddress;
+  uint256_t key;
+
+  bool operator==(const SlotKey& a) const {
+    return key == a.key && codeAddress == a.codeAddress;
+  };
+};
+typedef SlotKey slot_key_t;
+
+struct WordHash {
+  size_t operator()(const uint256_t& value) const {
+    return fold(value);
+  }
+
+  static uint64_t fold(const uint256_t& value) {
+    return static_cast<uint64_t>(value) ^ static_cast<uint64_t>(value >> 64)
+      ^ static_cast<uint64_t>(value >> 128) ^ static_cast<uint64_t>(value >> 192);
+  }
+};
+
+struct SlotKeyHash {
+  size_t operator()(const slot_key_t& slot) const {
+    return (WordHash::fold(slot.key) * 0x9e3779b97f4a7c15) ^ WordHash::fold(slot.codeAddress);
+  }
+};
+
+// everything an ecrecover result depends on
+struct RecoveryKey {
+  uint256_t hash;
+  uint8_t recoveryId;
+  uint256_t r;
+  uint256_t s;
+
+  bool operator==(const RecoveryKey& a) const {
+    return hash == a.hash && recoveryId == a.recoveryId && r == a.r && s == a.s;
+  };
+};
+typedef RecoveryKey recovery_key_t;
+
+struct RecoveryKeyHash {
+  size_t operator()(const recovery_key_t& key) const {
+    return (WordHash::fold(key.r) * 0x9e3779b97f4a7c15) ^ WordHash::fold(key.hash) ^ key.recoveryId;
+  }
+};
+
+// running totals of the pending balanceChange entries for one address
+struct BalanceLedger {
+  BalanceAddressType addressType;
+  uint64_t changes;
+  uint256_t additions;
+  uint256_t subtractions;
+};
+typedef BalanceLedger balance_ledger_t;
+
+// which accountState entry a slot resolved to before the matching entry was written
+struct SlotUndo {
+  bool existed;
+  size_t previous;
+};
+typedef SlotUndo slot_undo_t;
+
+/*
+  Lengths of the pending change lists when a frame started; rolling back to it drops everything
+  the frame and its children did, including children that had already returned successfully.
+*/
+struct Checkpoint {
+  size_t logs;
+  size_t accountState;
+  size_t balanceChange;
+  size_t selfDestruct;
+  size_t contractCreated;
+};
+typedef Checkpoint checkpoint_t;
 
 struct {
   bool operator()(balance_change_t a, balance_change_t b) const {   
@@ -81,6 +153,49 @@ class PendingState {
   private:
     uint64_t stateNonce;
     std::vector<contract_creation_t> contractCreated;
+    // index of the latest accountState entry for each slot
+    std::unordered_map<slot_key_t, size_t, SlotKeyHash> slots;
+    std::vector<slot_undo_t> stateUndo;
+
+    void writeSlot(size_t index) {
+      const account_state_t& item = accountState[index];
+      auto inserted = slots.emplace(slot_key_t { item.codeAddress, item.key }, index);
+      if (inserted.second) {
+        stateUndo.push_back({false, 0});
+      } else {
+        stateUndo.push_back({true, inserted.first->second});
+        inserted.first->second = index;
+      }
+    }
+
+    std::unordered_map<uint256_t, balance_ledger_t, WordHash> ledger;
+    std::vector<resolved_balance_t> changedBalances;
+
+    void applyBalanceChange(const balance_change_t& item) {
+      auto inserted = ledger.emplace(item.address, balance_ledger_t { item.addressType, 0, 0, 0 });
+      if (inserted.second) changedBalances.push_back({item.addressType, item.address});
+      balance_ledger_t& entry = inserted.first->second;
+      entry.changes++;
+      if (item.type == BalanceChangeType::BALANCE_CHANGE_ADD) entry.additions += item.value;
+      if (item.type == BalanceChangeType::BALANCE_CHANGE_SUBTRACT) entry.subtractions += item.value;
+    }
+
+    /*
+      Changes are undone newest first, so an address whose first change is undone was also
+      the last one added to changedBalances.
+    */
+    void undoBalanceChange(const balance_change_t& item) {
+      auto found = ledger.find(item.address);
+      balance_ledger_t& entry = found->second;
+      if (--entry.changes == 0) {
+        ledger.erase(found);
+        changedBalances.pop_back();
+        return;
+      }
+      if (item.type == BalanceChangeType::BALANCE_CHANGE_ADD) entry.additions -= item.value;
+      if (item.type == BalanceChangeType::BALANCE_CHANGE_SUBTRACT) entry.subtractions -= item.value;
+    }
+
   public:
     uint64_t currentStackDepth;
     std::vector<log_t> logs;
@@ -88,41 +203,39 @@ class PendingState {
     std::vector<balance_change_t> balanceChange;
     std::vector<self_destruct_t> selfDestruct;
     std::vector<contract_creation_t> revertedContractCreation;
+    CodeAnalysisCache codeAnalysis;
+    // recovered addresses (empty when recovery failed); kept across reverts since they never change
+    std::unordered_map<recovery_key_t, bytes_t, RecoveryKeyHash> recoveredAddresses;
+    FrameArena frames;
   
-    void revert(uint64_t stackDepth) {
-      logs.erase(std::remove_if(
-        logs.begin(), logs.end(), [stackDepth](const log_t& item) { 
-          return item.stackDepth >= stackDepth;
-        }
-      ), logs.end());
-      accountState.erase(std::remove_if(
-        accountState.begin(), accountState.end(), [stackDepth](const account_state_t& item) { 
-          return item.stackDepth >= stackDepth;
-        }
-      ), accountState.end());
-      balanceChange.erase(std::remove_if(
-        balanceChange.begin(), balanceChange.end(), [stackDepth](const balance_change_t& item) { 
-          return item.stackDepth >= stackDepth;
-        }
-      ), balanceChange.end());
-      selfDestruct.erase(std::remove_if(
-        selfDestruct.begin(), selfDestruct.end(), [stackDepth](const self_destruct_t& item) { 
-          return item.stackDepth >= stackDepth;
-        }
-      ), selfDestruct.end());
-      std::vector<contract_creation_t> revertedContracts;
-      std::copy_if(
-        contractCreated.begin(), contractCreated.end(), std::back_inserter(revertedContracts), [stackDepth](const contract_creation_t& item) { 
-          return item.stackDepth >= stackDepth;
+    checkpoint_t checkpoint() const {
+      return { logs.size(), accountState.size(), balanceChange.size(), selfDestruct.size(), contractCreated.size() };
+    }
+
+    void revert(const checkpoint_t& checkpoint) {
+      logs.resize(checkpoint.logs);
+      while (accountState.size() > checkpoint.accountState) {
+        const account_state_t& item = accountState.back();
+        const slot_undo_t& undo = stateUndo.back();
+        if (undo.existed) {
+          slots[slot_key_t { item.codeAddress, item.key }] = undo.previous;
+        } else {
+          slots.erase(slot_key_t { item.codeAddress, item.key });
         }
-      );
-      if (revertedContracts.size() > 0) {
-        revertedContractCreation.insert(
-          revertedContractCreation.end(), 
-          revertedContracts.begin(), 
-          revertedContracts.end()
-        );
+        accountState.pop_back();
+        stateUndo.pop_back();
+      }
+      while (balanceChange.size() > checkpoint.balanceChange) {
+        undoBalanceChange(balanceChange.back());
+        balanceChange.pop_back();
       }
+      selfDestruct.resize(checkpoint.selfDestruct);
+      revertedContractCreation.insert(
+        revertedContractCreation.end(),
+        contractCreated.begin() + checkpoint.contractCreated,
+        contractCreated.end()
+      );
+      contractCreated.resize(checkpoint.contractCreated);
     }
 
     void log(const std::vector<uint256_t>& topics, bytes_t data) {
@@ -132,6 +245,15 @@ class PendingState {
     void putState(const uint256_t& key, const uint256_t& value, const uint256_t& codeAddress) {
       stateNonce += 1;
       accountState.push_back({currentStackDepth, stateNonce, key, value, codeAddress});
+      writeSlot(accountState.size() - 1);
+    }
+
+    // the last write to each slot; earlier writes to the same slot are superseded
+    std::vector<account_state_t> resolvedAccountState() const {
+      std::vector<account_state_t> resolved;
+      resolved.reserve(slots.size());
+      for (const auto& slot : slots) resolved.push_back(accountState[slot.second]);
+      return resolved;
     }
 
     uint256_t getState(const uint256_t& key, const uint256_t& codeAddress) {
@@ -142,21 +264,9 @@ class PendingState {
 
     template <typename F>
     uint256_t getState(const uint256_t& key, const uint256_t& codeAddress, F&& external) {
-      std::vector<account_state_t> results;
-      std::copy_if(
-        accountState.begin(), accountState.end(), std::back_inserter(results), [key, codeAddress](const account_state_t& item) { 
-          return item.key == key && item.codeAddress == codeAddress;
-        }
-      );
- 
-      if (results.size() > 0) {
-        if (results.size() > 1) {
-          std::sort(results.begin(), results.end(), nonceOrder);
-        }
-        return std::prev(results.end())->value;
-      } else {
-        return external();
-      }
+      auto found = slots.find(slot_key_t { codeAddress, key });
+      if (found != slots.end()) return accountState[found->second].value;
+      return external();
     }
 
     void putBalanceChange(
@@ -166,6 +276,7 @@ class PendingState {
       const uint256_t& value
     ) {
       balanceChange.push_back({currentStackDepth, type, addressType, address, value});
+      applyBalanceChange(balanceChange.back());
     }
 
     uint256_t balanceWithPendingChanges(const uint256_t& address, const uint256_t& persistedBalance) {
@@ -173,37 +284,19 @@ class PendingState {
     }
 
     std::pair<BalanceAddressType, uint256_t> resolveAddressBalanceChanges(const uint256_t& address, const uint256_t& persistedBalance) {
-      std::vector<balance_change_t> results;
-      std::copy_if(
-        balanceChange.begin(), balanceChange.end(), std::back_inserter(results), [address](const balance_change_t& item) { 
-          return item.address == address;
-        }
-      );
-      if (results.size() == 0) return std::make_pair(BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, persistedBalance);
-
-      BalanceAddressType addressType = results[0].addressType;
-      uint256_t pendingAdditions = uint256_t(0);
-      uint256_t pendingSubtractions = uint256_t(0);
-      for (int i = 0; i < results.size(); i++) {
-        if (results[i].type == BalanceChangeType::BALANCE_CHANGE_ADD)
-          pendingAdditions += results[i].value;
-        if (results[i].type == BalanceChangeType::BALANCE_CHANGE_SUBTRACT)
-          pendingSubtractions += results[i].value;
-      }
+      auto found = ledger.find(address);
+      if (found == ledger.end()) return std::make_pair(BalanceAddressType::BALANCE_ADDRESS_ACCOUNT, persistedBalance);
 
+      const balance_ledger_t& entry = found->second;
       return std::make_pair(
-        addressType,
-        Overflow::sub(persistedBalance + pendingAdditions, pendingSubtractions).first
+        entry.addressType,
+        Overflow::sub(persistedBalance + entry.additions, entry.subtractions).first
       );
     }
 
-    std::set<resolved_balance_t> resolvedBalanceAddresses() {
-      if (balanceChange.size() == 0) return std::set<resolved_balance_t>();
-      std::set<resolved_balance_t> changedAddress;
-      for (int i = 0; i < balanceChange.size(); i++) {
-        changedAddress.insert({balanceChange[i].addressType, balanceChange[i].address});
-      }
-      return changedAddress;
+    // every address with a pending balance change, in the order they were first touched
+    const std::vector<resolved_balance_t>& resolvedBalanceAddresses() const {
+      return changedBalances;
     }
 
     void putSelfDestruct(const uint256_t& address) {
@@ -0,0 +1,243 @@
+#pragma once
+#include <limits>
+#include <evm/types.h>
+#include <evm/external.h>
+#include <evm/pending_state.hpp>
+#include <evm/address.hpp>
+#include <evm/big_int.hpp>
+#include <evm/modexp.hpp>
+#include <evm/alt_bn128.hpp>
+#include <evm/blake2b.hpp>
+
+enum PrecompileResult {
+  PRECOMPILE_SUCCESS,
+  PRECOMPILE_FAILED
+};
+
+typedef std::pair<PrecompileResult, bytes_t> precompile_result_t;
+
+/*
+  Contracts at the reserved low addresses that run natively rather than as bytecode. A call is
+  priced from its input before it runs; a failed run consumes all the gas given to the call.
+  Hashing and key recovery go through External so the contract build can use the host's
+  implementations.
+*/
+class Precompile {
+  public:
+    static const uint8_t ECRECOVER = 0x01;
+    static const uint8_t SHA256 = 0x02;
+    static const uint8_t RIPEMD160 = 0x03;
+    static const uint8_t IDENTITY = 0x04;
+    static const uint8_t MODEXP = 0x05;
+    static const uint8_t BN128_ADD = 0x06;
+    static const uint8_t BN128_MUL = 0x07;
+    static const uint8_t BN128_PAIRING = 0x08;
+    static const uint8_t BLAKE2F = 0x09;
+
+    static bool exists(const uint256_t& address) {
+      switch (index(address)) {
+        case ECRECOVER:
+        case SHA256:
+        case RIPEMD160:
+        case IDENTITY:
+        case MODEXP:
+        case BN128_ADD:
+        case BN128_MUL:
+        case BN128_PAIRING:
+        case BLAKE2F:
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    static gas_t gas(const uint256_t& address, const bytes_t& input) {
+      gas_t words = (input.size() + 31) / 32;
+      switch (index(address)) {
+        case ECRECOVER:
+          return 3000;
+        case SHA256:
+          return 60 + 12 * words;
+        case RIPEMD160:
+          return 600 + 120 * words;
+        case IDENTITY:
+          return 15 + 3 * words;
+        case MODEXP:
+          return modexpGas(input);
+        case BN128_ADD:
+          return 150;
+        case BN128_MUL:
+          return 6000;
+        case BN128_PAIRING:
+          return 45000 + 34000 * (input.size() / 192);
+        case BLAKE2F:
+          // one per round; malformed input costs nothing and fails
+          return input.size() == BLAKE2F_INPUT_SIZE ? readUint32(input, 0) : 0;
+        default:
+          return 0;
+      }
+    }
+
+    static precompile_result_t run(
+      const uint256_t& address,
+      const bytes_t& input,
+      External& external,
+      PendingState& pendingState
+    ) {
+      switch (index(address)) {
+        case ECRECOVER:
+          return std::make_pair(PrecompileResult::PRECOMPILE_SUCCESS, ecrecover(input, external, pendingState));
+        case SHA256:
+          return std::make_pair(PrecompileResult::PRECOMPILE_SUCCESS, external.sha256(input));
+        case RIPEMD160:
+          {
+            bytes_t output(12, 0);
+            bytes_t hash = external.ripemd160(input);
+            output.insert(output.end(), hash.begin(), hash.end());
+            return std::make_pair(PrecompileResult::PRECOMPILE_SUCCESS, output);
+          }
+        case IDENTITY:
+          return std::make_pair(PrecompileResult::PRECOMPILE_SUCCESS, input);
+        case MODEXP:
+          return std::make_pair(PrecompileResult::PRECOMPILE_SUCCESS, modexp(input));
+        case BN128_ADD:
+          return bn128(AltBn128::add, input);
+        case BN128_MUL:
+          return bn128(AltBn128::multiply, input);
+        case BN128_PAIRING:
+          return bn128(AltBn128::pairing, input);
+        case BLAKE2F:
+          return blake2f(input);
+        default:
+          return std::make_pair(PrecompileResult::PRECOMPILE_FAILED, bytes_t());
+      }
+    }
+
+  private:
+    static const size_t BLAKE2F_INPUT_SIZE = 213;
+
+    /*
+      hash, v, r, s as words, zero padded; v must be 27 or 28. A signature that does not recover
+      gives empty output rather than a failure. Contracts tend to check the same signature more
+      than once, so results are memoised in the pending state.
+    */
+    static bytes_t ecrecover(const bytes_t& input, External& external, PendingState& pendingState) {
+      uint8_t padded[128] = { 0 };
+      std::copy(input.begin(), input.begin() + std::min<size_t>(input.size(), 128), padded);
+      uint256_t v = BigInt::fromBigEndianBytes(padded + 32, WORD_SIZE);
+      if (v != 27 && v != 28) return bytes_t();
+
+      recovery_key_t key {
+        BigInt::fromBigEndianBytes(padded, WORD_SIZE),
+        static_cast<uint8_t>(v - 27),
+        BigInt::fromBigEndianBytes(padded + 64, WORD_SIZE),
+        BigInt::fromBigEndianBytes(padded + 96, WORD_SIZE)
+      };
+      auto found = pendingState.recoveredAddresses.find(key);
+      if (found != pendingState.recoveredAddresses.end()) return found->second;
+
+      bytes_t output;
+      bytes_t publicKey = external.ecrecover(key.hash, key.recoveryId, key.r, key.s);
+      if (!publicKey.empty()) {
+        bytes_t address = Address::ethereumAddress(publicKey);
+        output.assign(12, 0);
+        output.insert(output.end(), address.begin(), address.end());
+      }
+      pendingState.recoveredAddresses.emplace(key, output);
+      return output;
+    }
+
+    /*
+      EIP-2565: the cost of one multiplication, from the wider of base and modulus, times the
+      number of squarings the exponent needs, at least 200. Lengths too large to be paid for
+      saturate rather than overflow.
+    */
+    static gas_t modexpGas(const bytes_t& input) {
+      uint256_t baseSize = BigInt::fromBigEndianBytes(slice(input, 0, WORD_SIZE));
+      uint256_t exponentSize = BigInt::fromBigEndianBytes(slice(input, WORD_SIZE, WORD_SIZE));
+      uint256_t modulusSize = BigInt::fromBigEndianBytes(slice(input, 2 * WORD_SIZE, WORD_SIZE));
+
+      uint256_t width = baseSize > modulusSize ? baseSize : modulusSize;
+      if (width == 0) return 200;
+      uint256_t limit = uint256_t(1) << 64;
+      if (width > limit || exponentSize > limit) return std::numeric_limits<gas_t>::max();
+
+      uint64_t headSize = exponentSize > WORD_SIZE ? WORD_SIZE : static_cast<uint64_t>(exponentSize);
+      size_t headBits = ModExp::bitLength(slice(input, 3 * WORD_SIZE + baseSize, headSize));
+      uint256_t iterations = headBits > 0 ? headBits - 1 : 0;
+      if (exponentSize > WORD_SIZE) iterations += 8 * (exponentSize - WORD_SIZE);
+      if (iterations == 0) iterations = 1;
+
+      uint256_t words = (width + 7) / 8;
+      uint256_t cost = words * words * iterations / 3;
+      if (cost < 200) return 200;
+      if (cost > std::numeric_limits<gas_t>::max()) return std::numeric_limits<gas_t>::max();
+      return static_cast<gas_t>(cost);
+    }
+
+    // three length words, then base, exponent and modulus; an empty modulus gives empty output
+    static bytes_t modexp(const bytes_t& input) {
+      uint64_t baseSize = static_cast<uint64_t>(BigInt::fromBigEndianBytes(slice(input, 0, WORD_SIZE)));
+      uint64_t exponentSize = static_cast<uint64_t>(BigInt::fromBigEndianBytes(slice(input, WORD_SIZE, WORD_SIZE)));
+      uint64_t modulusSize = static_cast<uint64_t>(BigInt::fromBigEndianBytes(slice(input, 2 * WORD_SIZE, WORD_SIZE)));
+      if (modulusSize == 0) return bytes_t();
+
+      uint256_t offset = 3 * WORD_SIZE;
+      bytes_t base = slice(input, offset, baseSize);
+      bytes_t exponent = slice(input, offset + baseSize, exponentSize);
+      bytes_t modulus = slice(input, offset + baseSize + exponentSize, modulusSize);
+      return ModExp::power(base, exponent, modulus);
+    }
+
+    static precompile_result_t bn128(bool (*operation)(const bytes_t&, bytes_t&), const bytes_t& input) {
+      bytes_t output;
+      if (!operation(input, output)) return std::make_pair(PrecompileResult::PRECOMPILE_FAILED, bytes_t());
+      return std::make_pair(PrecompileResult::PRECOMPILE_SUCCESS, output);
+    }
+
+    // rounds as a big-endian word, then h, m and t as little-endian words, then the final block flag
+    static precompile_result_t blake2f(const bytes_t& input) {
+      if (input.size() != BLAKE2F_INPUT_SIZE || input[212] > 1) {
+        return std::make_pair(PrecompileResult::PRECOMPILE_FAILED, bytes_t());
+      }
+
+      uint64_t h[8];
+      uint64_t m[16];
+      uint64_t t[2];
+      for (size_t i = 0; i < 8; i++) h[i] = readUint64(input, 4 + 8 * i);
+      for (size_t i = 0; i < 16; i++) m[i] = readUint64(input, 68 + 8 * i);
+      for (size_t i = 0; i < 2; i++) t[i] = readUint64(input, 196 + 8 * i);
+      Blake2b::compress(readUint32(input, 0), h, m, t, input[212] == 1);
+
+      bytes_t output(64, 0);
+      for (size_t i = 0; i < 64; i++) output[i] = static_cast<uint8_t>(h[i / 8] >> (8 * (i % 8)));
+      return std::make_pair(PrecompileResult::PRECOMPILE_SUCCESS, output);
+    }
+
+    static uint32_t readUint32(const bytes_t& input, size_t offset) {
+      uint32_t value = 0;
+      for (size_t i = 0; i < 4; i++) value = (value << 8) | input[offset + i];
+      return value;
+    }
+
+    static uint64_t readUint64(const bytes_t& input, size_t offset) {
+      uint64_t value = 0;
+      for (size_t i = 8; i > 0; i--) value = (value << 8) | input[offset + i - 1];
+      return value;
+    }
+
+    // size bytes of input from offset, zero padded past its end
+    static bytes_t slice(const bytes_t& input, const uint256_t& offset, uint64_t size) {
+      bytes_t result(size, 0);
+      if (offset < input.size()) {
+        uint64_t start = static_cast<uint64_t>(offset);
+        uint64_t available = std::min<uint64_t>(size, input.size() - start);
+        std::copy(input.begin() + start, input.begin() + start + available, result.begin());
+      }
+      return result;
+    }
+
+    static uint8_t index(const uint256_t& address) {
+      return address < 0x100 ? static_cast<uint8_t>(address) : 0;
+    }
+};
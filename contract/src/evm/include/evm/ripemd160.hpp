@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cstring>
+#include <evm/types.h>
+
+// RIPEMD-160, for the 0x03 precompile when no host implementation is available
+class Ripemd160 {
+  public:
+    static std::array<uint8_t, 20> hash(const uint8_t* data, size_t size) {
+      uint32_t state[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+      size_t blocks = size / 64;
+      for (size_t i = 0; i < blocks; i++) compress(state, data + i * 64);
+
+      // same padding as SHA-256 but with a little-endian bit length
+      uint8_t tail[128] = { 0 };
+      size_t remaining = size - blocks * 64;
+      std::memcpy(tail, data + blocks * 64, remaining);
+      tail[remaining] = 0x80;
+      size_t tailSize = remaining < 56 ? 64 : 128;
+      uint64_t bits = static_cast<uint64_t>(size) * 8;
+      for (size_t i = 0; i < 8; i++) tail[tailSize - 8 + i] = static_cast<uint8_t>(bits >> (8 * i));
+      for (size_t offset = 0; offset < tailSize; offset += 64) compress(state, tail + offset);
+
+      std::array<uint8_t, 20> digest;
+      for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < 4; j++) digest[i * 4 + j] = static_cast<uint8_t>(state[i] >> (8 * j));
+      }
+      return digest;
+    }
+
+  private:
+    static uint32_t rotl(uint32_t x, unsigned n) {
+      return (x << n) | (x >> (32 - n));
+    }
+
+    static uint32_t f(size_t round, uint32_t x, uint32_t y, uint32_t z) {
+      switch (round) {
+        case 0: return x ^ y ^ z;
+        case 1: return (x & y) | (~x & z);
+        case 2: return (x | ~y) ^ z;
+        case 3: return (x & z) | (y & ~z);
+        default: return x ^ (y | ~z);
+      }
+    }
+
+    static void compress(uint32_t state[5], const uint8_t* block) {
+      static const uint8_t r[80] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+        7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+        3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+        1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+        4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+      };
+      static const uint8_t rPrime[80] = {
+        5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+        6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+        15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+        8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+        12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+      };
+      static const uint8_t s[80] = {
+        11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+        7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+        11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+        11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+        9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+      };
+      static const uint8_t sPrime[80] = {
+        8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+        9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+        9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+        15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+        8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+      };
+      static const uint32_t k[5] = { 0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e };
+      static const uint32_t kPrime[5] = { 0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000 };
+
+      uint32_t x[16];
+      for (size_t i = 0; i < 16; i++) {
+        x[i] = static_cast<uint32_t>(block[i * 4]) | (static_cast<uint32_t>(block[i * 4 + 1]) << 8)
+          | (static_cast<uint32_t>(block[i * 4 + 2]) << 16) | (static_cast<uint32_t>(block[i * 4 + 3]) << 24);
+      }
+
+      uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+      uint32_t aPrime = a, bPrime = b, cPrime = c, dPrime = d, ePrime = e;
+      for (size_t j = 0; j < 80; j++) {
+        size_t round = j / 16;
+        uint32_t t = rotl(a + f(round, b, c, d) + x[r[j]] + k[round], s[j]) + e;
+        a = e;
+        e = d;
+        d = rotl(c, 10);
+        c = b;
+        b = t;
+
+        t = rotl(aPrime + f(4 - round, bPrime, cPrime, dPrime) + x[rPrime[j]] + kPrime[round], sPrime[j]) + ePrime;
+        aPrime = ePrime;
+        ePrime = dPrime;
+        dPrime = rotl(cPrime, 10);
+        cPrime = bPrime;
+        bPrime = t;
+      }
+
+      uint32_t t = state[1] + c + dPrime;
+      state[1] = state[2] + d + ePrime;
+      state[2] = state[3] + e + aPrime;
+      state[3] = state[4] + a + bPrime;
+      state[4] = state[0] + b + cPrime;
+      state[0] = t;
+    }
+};
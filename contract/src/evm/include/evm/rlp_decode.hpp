@@ -2,96 +2,109 @@
 #include <memory>
 #include <evm/types.h>
 
+/*
+  An item inside an encoded buffer. payload is the string bytes or the encoded list contents,
+  encoded covers the item including its prefix. Both point into the buffer being read.
+*/
+struct RLPView {
+  RLPType type;
+  const uint8_t* payload;
+  uint64_t payloadSize;
+  const uint8_t* encoded;
+  uint64_t encodedSize;
+};
+typedef RLPView rlp_view_t;
+
+class RLPReader {
+  public:
+    RLPReader(const uint8_t* data, uint64_t size): data(data), size(size), position(0), malformed(false) {};
+
+    explicit RLPReader(const bytes_t& bytes): RLPReader(bytes.data(), bytes.size()) {};
+
+    explicit RLPReader(const rlp_view_t& list): RLPReader(list.payload, list.payloadSize) {};
+
+    // false at the end of the buffer or when the next item runs past it
+    bool next(rlp_view_t& item) {
+      if (malformed || position >= size) return false;
+
+      const uint8_t* encoded = data + position;
+      uint64_t remaining = size - position;
+      uint8_t prefix = encoded[0];
+      uint64_t headerSize = 1;
+      uint64_t payloadSize = 0;
+      RLPType type = prefix < OFFSET_SHORT_LIST ? RLPType::STRING : RLPType::LIST;
+
+      if (prefix < OFFSET_SHORT_STRING) {
+        headerSize = 0;
+        payloadSize = 1;
+      } else if (prefix <= OFFSET_LONG_STRING) {
+        payloadSize = prefix - OFFSET_SHORT_STRING;
+      } else if (prefix < OFFSET_SHORT_LIST) {
+        if (!readLength(encoded, remaining, prefix - OFFSET_LONG_STRING, payloadSize)) return fail();
+        headerSize += prefix - OFFSET_LONG_STRING;
+      } else if (prefix <= OFFSET_LONG_LIST) {
+        payloadSize = prefix - OFFSET_SHORT_LIST;
+      } else {
+        if (!readLength(encoded, remaining, prefix - OFFSET_LONG_LIST, payloadSize)) return fail();
+        headerSize += prefix - OFFSET_LONG_LIST;
+      }
+
+      if (headerSize > remaining || payloadSize > remaining - headerSize) return fail();
+
+      item = { type, encoded + headerSize, payloadSize, encoded, headerSize + payloadSize };
+      position += headerSize + payloadSize;
+      return true;
+    }
+
+    bool isMalformed() const {
+      return malformed;
+    }
+
+  private:
+    const uint8_t* data;
+    uint64_t size;
+    uint64_t position;
+    bool malformed;
+
+    bool fail() {
+      malformed = true;
+      return false;
+    }
+
+    static bool readLength(const uint8_t* encoded, uint64_t remaining, uint8_t lengthOfLength, uint64_t& length) {
+      if (lengthOfLength > 8 || lengthOfLength >= remaining) return false;
+      length = 0;
+      for (uint8_t i = 1; i <= lengthOfLength; i++) {
+        length = (length << 8) | encoded[i];
+      }
+      return true;
+    }
+};
+
 class RLPDecode {
   public:
     static void decode(const bytes_t& encoded, rlp_list_t* output) {
-      traverse(encoded, 0, encoded.size(), output);
+      RLPReader reader(encoded);
+      traverse(reader, output);
     }
 
   private:
-    static void traverse(
-      const bytes_t& data, 
-      uint16_t startPos,
-      uint16_t end, 
-      rlp_list_t* output
-    ) {
-      if (data.size() == 0) return;
-      while (startPos < end) {
-        uint8_t prefix = data[startPos] & 0xff;
-        if (prefix < OFFSET_SHORT_STRING) {
-          output->push_back({
-            RLPType::STRING,
-            bytes_t { prefix }
-          });
-          startPos += 1;
-        } else if (prefix == OFFSET_SHORT_STRING) {
-          output->push_back({
-            RLPType::STRING,
-            bytes_t()
-          });
-          startPos += 1;
-        } else if (prefix > OFFSET_SHORT_STRING && prefix <= OFFSET_LONG_STRING) {
-          uint8_t strLen = prefix - OFFSET_SHORT_STRING;
+    static void traverse(RLPReader& reader, rlp_list_t* output) {
+      rlp_view_t item;
+      while (reader.next(item)) {
+        if (item.type == RLPType::STRING) {
           output->push_back({
             RLPType::STRING,
-            bytes_t(
-              data.begin() + startPos + 1, 
-              data.begin() + startPos + strLen + 1
-            )
+            bytes_t(item.payload, item.payload + item.payloadSize)
           });
-          startPos += (strLen + 1);
-        } else if (prefix > OFFSET_LONG_STRING && prefix < OFFSET_SHORT_LIST) {
-          uint8_t lenOfStrLen = prefix - OFFSET_LONG_STRING;
-          uint16_t strLen = calculateLength(lenOfStrLen, data, startPos);
-          output->push_back({
-            RLPType::STRING,
-            bytes_t(
-              data.begin() + startPos + lenOfStrLen + 1, 
-              data.begin() + startPos + lenOfStrLen + strLen + 1
-            )
-          });
-          startPos += (lenOfStrLen + strLen + 1);
-        } else if (prefix >= OFFSET_SHORT_LIST && prefix <= OFFSET_LONG_LIST) {
-          uint8_t listLen = prefix - OFFSET_SHORT_LIST;
-          rlp_list_t* newLevelList = new rlp_list_t();
-          traverse(data, startPos + 1, startPos + listLen + 1, newLevelList);
+        } else {
           output->push_back({
             RLPType::LIST,
-            rlp_list_t(newLevelList->begin(), newLevelList->end())
+            rlp_list_t()
           });
-          startPos += (listLen + 1);
-          delete newLevelList;
-        } else if (prefix > OFFSET_LONG_LIST) {
-          uint8_t lenOfListLen = (prefix - OFFSET_LONG_LIST);
-          uint16_t listLen = calculateLength(lenOfListLen, data, startPos);
-          rlp_list_t* newLevelList = new rlp_list_t();
-          traverse(
-            data, 
-            startPos + lenOfListLen + 1, 
-            startPos + lenOfListLen + listLen + 1, 
-            newLevelList
-          );
-          output->push_back({
-            RLPType::LIST,
-            rlp_list_t(newLevelList->begin(), newLevelList->end())
-          });
-          startPos += (lenOfListLen + listLen + 1);
-          delete newLevelList;
+          RLPReader listReader(item);
+          traverse(listReader, &std::get<rlp_list_t>(output->back().value));
         }
       }
     }
-
-    static uint16_t calculateLength(
-      uint8_t lengthOfLength, 
-      const bytes_t& data,
-      uint16_t pos
-    ) {
-      uint8_t pow = lengthOfLength - 1;
-      uint16_t length = 0;
-      for (int i = 1; i <= lengthOfLength; ++i) {
-        length += (data[pos + i] & 0xff) << (8 * pow);
-        pow--;
-      }
-      return length;
-    }
-};
\ No newline at end of file
+};
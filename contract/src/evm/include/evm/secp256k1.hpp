@@ -0,0 +1,159 @@
+#pragma once
+#include <evm/types.h>
+#include <evm/big_int.hpp>
+#include <evm/secp256k1_field.hpp>
+
+/*
+  Public key recovery from an ECDSA signature over secp256k1, for the ecrecover precompile when
+  no host implementation is available. Only recovery ids 0 and 1 are handled, i.e. R.x = r;
+  the ids that need r + n are never produced by Ethereum signers.
+*/
+class Secp256k1 {
+  public:
+    static constexpr uint256_t N = intx::from_string<uint256_t>("0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141");
+
+    /*
+      Whether recover succeeds, without working out the key. The key is at infinity exactly when
+      s R = e G, i.e. R = (e / s) G, which takes one multiple of G to rule out rather than the two
+      scalars and the inversions of a full recovery.
+    */
+    static bool recoverable(const uint256_t& hash, uint8_t recoveryId, const uint256_t& r, const uint256_t& s) {
+      if (recoveryId > 1 || r == 0 || r >= N || s == 0 || s >= N) return false;
+      Secp256k1Field y;
+      if (!liftX(r, recoveryId, y)) return false;
+
+      uint256_t e = hash >= N ? hash - N : hash;
+      if (e == 0) return true;
+      Point p = multiplyAdd(intx::mulmod(e, inverseModN(s), N), 0, Point::affine(Secp256k1Field(r), y));
+      if (p.infinity) return true;
+      // compare with R = (r, y) without leaving Jacobian coordinates
+      Secp256k1Field z2 = p.z.square();
+      return !(p.x == Secp256k1Field(r) * z2 && p.y == y * z2 * p.z);
+    }
+
+    // the 64 byte uncompressed key x || y, or empty when there is none
+    static bytes_t recover(const uint256_t& hash, uint8_t recoveryId, const uint256_t& r, const uint256_t& s) {
+      if (recoveryId > 1 || r == 0 || r >= N || s == 0 || s >= N) return bytes_t();
+
+      Secp256k1Field y;
+      if (!liftX(r, recoveryId, y)) return bytes_t();
+
+      // Q = r^-1 (s R - e G)
+      uint256_t e = hash >= N ? hash - N : hash;
+      uint256_t rInverse = inverseModN(r);
+      uint256_t u1 = e == 0 ? 0 : intx::mulmod(N - e, rInverse, N);
+      uint256_t u2 = intx::mulmod(s, rInverse, N);
+
+      Point q = multiplyAdd(u1, u2, Point::affine(Secp256k1Field(r), y));
+      if (q.infinity) return bytes_t();
+
+      Secp256k1Field zInverse = q.z.inverse();
+      Secp256k1Field zInverse2 = zInverse.square();
+      bytes_t key = BigInt::toBytes((q.x * zInverse2).word());
+      bytes_t yBytes = BigInt::toBytes((q.y * zInverse2 * zInverse).word());
+      key.insert(key.end(), yBytes.begin(), yBytes.end());
+      return key;
+    }
+
+  private:
+    // Jacobian coordinates, (x / z^2, y / z^3)
+    struct Point {
+      Secp256k1Field x;
+      Secp256k1Field y;
+      Secp256k1Field z;
+      bool infinity;
+
+      static Point affine(const Secp256k1Field& x, const Secp256k1Field& y) {
+        return Point { x, y, Secp256k1Field(1), false };
+      }
+
+      static Point atInfinity() {
+        return Point { Secp256k1Field(), Secp256k1Field(), Secp256k1Field(), true };
+      }
+    };
+
+    static bool liftX(const uint256_t& x, uint8_t recoveryId, Secp256k1Field& y) {
+      Secp256k1Field xElement(x);
+      Secp256k1Field ySquared = xElement.square() * xElement + Secp256k1Field(7);
+      y = ySquared.sqrt();
+      if (!(y.square() == ySquared)) return false;
+      if (y.isOdd() != (recoveryId == 1)) y = y.negate();
+      return true;
+    }
+
+    static Point doublePoint(const Point& p) {
+      if (p.infinity || p.y == Secp256k1Field()) return Point::atInfinity();
+      Secp256k1Field a = p.x.square();
+      Secp256k1Field b = p.y.square();
+      Secp256k1Field c = b.square();
+      Secp256k1Field d = (p.x + b).square() - a - c;
+      d = d + d;
+      Secp256k1Field e = a + a + a;
+      Secp256k1Field x = e.square() - d - d;
+      Secp256k1Field c8 = c + c;
+      c8 = c8 + c8;
+      c8 = c8 + c8;
+      Secp256k1Field y = e * (d - x) - c8;
+      Secp256k1Field z = p.y * p.z;
+      return Point { x, y, z + z, false };
+    }
+
+    static Point add(const Point& p, const Point& q) {
+      if (p.infinity) return q;
+      if (q.infinity) return p;
+
+      Secp256k1Field pz2 = p.z.square();
+      Secp256k1Field qz2 = q.z.square();
+      Secp256k1Field u1 = p.x * qz2;
+      Secp256k1Field u2 = q.x * pz2;
+      Secp256k1Field s1 = p.y * qz2 * q.z;
+      Secp256k1Field s2 = q.y * pz2 * p.z;
+      Secp256k1Field h = u2 - u1;
+      Secp256k1Field r = s2 - s1;
+
+      if (h == Secp256k1Field()) {
+        if (r == Secp256k1Field()) return doublePoint(p);
+        return Point::atInfinity();
+      }
+
+      Secp256k1Field h2 = h.square();
+      Secp256k1Field h3 = h2 * h;
+      Secp256k1Field u1h2 = u1 * h2;
+      Secp256k1Field x = r.square() - h3 - u1h2 - u1h2;
+      Secp256k1Field y = r * (u1h2 - x) - s1 * h3;
+      return Point { x, y, p.z * q.z * h, false };
+    }
+
+    // u1 G + u2 R in one pass over the bits of both scalars
+    static Point multiplyAdd(const uint256_t& u1, const uint256_t& u2, const Point& r) {
+      static const Point g = Point::affine(
+        Secp256k1Field(intx::from_string<uint256_t>("0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798")),
+        Secp256k1Field(intx::from_string<uint256_t>("0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8"))
+      );
+      Point both = add(g, r);
+
+      Point result = Point::atInfinity();
+      for (size_t i = 256; i > 0; i--) {
+        result = doublePoint(result);
+        bool first = ((u1 >> (i - 1)) & 1) != 0;
+        bool second = ((u2 >> (i - 1)) & 1) != 0;
+        if (first && second) result = add(result, both);
+        else if (first) result = add(result, g);
+        else if (second) result = add(result, r);
+      }
+      return result;
+    }
+
+    // Fermat's little theorem, r^(n - 2) mod n
+    static uint256_t inverseModN(const uint256_t& value) {
+      uint256_t exponent = N - 2;
+      uint256_t result = 1;
+      uint256_t base = value;
+      while (exponent != 0) {
+        if ((exponent & 1) != 0) result = intx::mulmod(result, base, N);
+        base = intx::mulmod(base, base, N);
+        exponent >>= 1;
+      }
+      return result;
+    }
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include <evm/types.h>
+
+/*
+  An element of the secp256k1 base field, p = 2^256 - 2^32 - 977, kept fully reduced in four
+  little-endian 64-bit limbs. Since 2^256 = 2^32 + 977 (mod p) a 512-bit product is reduced by
+  folding its high half back in twice, which is much cheaper than a generic 512-bit division.
+*/
+class Secp256k1Field {
+  public:
+    Secp256k1Field(): limbs { 0, 0, 0, 0 } {};
+
+    explicit Secp256k1Field(const uint256_t& value) {
+      for (size_t i = 0; i < 4; i++) limbs[i] = static_cast<uint64_t>(value >> (64 * i));
+      reduce(0);
+    }
+
+    uint256_t word() const {
+      uint256_t value = 0;
+      for (size_t i = 4; i > 0; i--) value = (value << 64) | limbs[i - 1];
+      return value;
+    }
+
+    bool isOdd() const {
+      return (limbs[0] & 1) != 0;
+    }
+
+    bool operator==(const Secp256k1Field& other) const {
+      return limbs[0] == other.limbs[0] && limbs[1] == other.limbs[1]
+        && limbs[2] == other.limbs[2] && limbs[3] == other.limbs[3];
+    }
+
+    Secp256k1Field operator+(const Secp256k1Field& other) const {
+      Secp256k1Field result;
+      uint64_t carry = 0;
+      for (size_t i = 0; i < 4; i++) {
+        intx::uint128 sum = intx::uint128(limbs[i]) + other.limbs[i] + carry;
+        result.limbs[i] = sum.lo;
+        carry = sum.hi;
+      }
+      result.reduce(carry);
+      return result;
+    }
+
+    Secp256k1Field operator*(const Secp256k1Field& other) const {
+      uint64_t product[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+      for (size_t i = 0; i < 4; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < 4; j++) {
+          intx::uint128 t = intx::umul(limbs[i], other.limbs[j]) + product[i + j] + carry;
+          product[i + j] = t.lo;
+          carry = t.hi;
+        }
+        product[i + 4] = carry;
+      }
+
+      // low + high * C, leaving a fifth limb below 2^34
+      Secp256k1Field result;
+      uint64_t carry = 0;
+      for (size_t i = 0; i < 4; i++) {
+        intx::uint128 t = intx::umul(product[i + 4], C) + product[i] + carry;
+        result.limbs[i] = t.lo;
+        carry = t.hi;
+      }
+
+      // fold the fifth limb in the same way
+      intx::uint128 t = intx::umul(carry, C) + result.limbs[0];
+      result.limbs[0] = t.lo;
+      carry = t.hi;
+      for (size_t i = 1; i < 4; i++) {
+        intx::uint128 sum = intx::uint128(result.limbs[i]) + carry;
+        result.limbs[i] = sum.lo;
+        carry = sum.hi;
+      }
+      result.reduce(carry);
+      return result;
+    }
+
+    Secp256k1Field operator-(const Secp256k1Field& other) const {
+      return *this + other.negate();
+    }
+
+    Secp256k1Field square() const {
+      return *this * *this;
+    }
+
+    Secp256k1Field negate() const {
+      Secp256k1Field zero;
+      if (*this == zero) return zero;
+      Secp256k1Field result;
+      uint64_t borrow = 0;
+      for (size_t i = 0; i < 4; i++) {
+        intx::uint128 difference = intx::uint128(P[i]) - limbs[i] - borrow;
+        result.limbs[i] = difference.lo;
+        borrow = difference.hi != 0 ? 1 : 0;
+      }
+      return result;
+    }
+
+    /*
+      this^((p + 1) / 4), the square root when one exists since p = 3 (mod 4). The exponent is
+      built with a fixed chain of 253 squarings and 13 multiplications, using runs of ones
+      x2, x3, x6, ... (x_n = this^(2^n - 1)) as in libsecp256k1.
+    */
+    Secp256k1Field sqrt() const {
+      Secp256k1Field x2, x22;
+      Secp256k1Field x223 = ones223(x2, x22);
+
+      Secp256k1Field result = x223.squareTimes(23) * x22;
+      result = result.squareTimes(6) * x2;
+      return result.squareTimes(2);
+    }
+
+    // this^(p - 2), the multiplicative inverse of a non-zero element, with the same chain
+    Secp256k1Field inverse() const {
+      Secp256k1Field x2, x22;
+      Secp256k1Field x223 = ones223(x2, x22);
+
+      Secp256k1Field result = x223.squareTimes(23) * x22;
+      result = result.squareTimes(5) * *this;
+      result = result.squareTimes(3) * x2;
+      return result.squareTimes(2) * *this;
+    }
+
+  private:
+    static constexpr uint64_t C = 0x1000003d1;
+    static constexpr uint64_t P[4] = { 0xfffffffefffffc2f, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff };
+
+    uint64_t limbs[4];
+
+    Secp256k1Field ones223(Secp256k1Field& x2, Secp256k1Field& x22) const {
+      x2 = square() * *this;
+      Secp256k1Field x3 = x2.square() * *this;
+      Secp256k1Field x6 = x3.squareTimes(3) * x3;
+      Secp256k1Field x9 = x6.squareTimes(3) * x3;
+      Secp256k1Field x11 = x9.squareTimes(2) * x2;
+      x22 = x11.squareTimes(11) * x11;
+      Secp256k1Field x44 = x22.squareTimes(22) * x22;
+      Secp256k1Field x88 = x44.squareTimes(44) * x44;
+      Secp256k1Field x176 = x88.squareTimes(88) * x88;
+      Secp256k1Field x220 = x176.squareTimes(44) * x44;
+      return x220.squareTimes(3) * x3;
+    }
+
+    Secp256k1Field squareTimes(size_t count) const {
+      Secp256k1Field result = *this;
+      for (size_t i = 0; i < count; i++) result = result.square();
+      return result;
+    }
+
+    // brings carry * 2^256 + limbs below p, for a carry of at most 1
+    void reduce(uint64_t carry) {
+      if (carry == 0 && !(limbs[3] == P[3] && limbs[2] == P[2] && limbs[1] == P[1] && limbs[0] >= P[0])) return;
+      // subtracting p is adding C and dropping the 2^256
+      uint64_t add = C;
+      for (size_t i = 0; i < 4; i++) {
+        intx::uint128 sum = intx::uint128(limbs[i]) + add;
+        limbs[i] = sum.lo;
+        add = sum.hi;
+      }
+    }
+};
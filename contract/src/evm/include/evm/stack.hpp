@@ -12,6 +12,11 @@ class StackMachine {
       stack.reserve(1024);
     };
 
+    // empties the stack but keeps its reserved storage
+    void reset() {
+      stack.clear();
+    }
+
     void pop(uint16_t n) {
       stack.resize(stack.size() - n);
     }
@@ -2,11 +2,37 @@
 #include <vector>
 #include <variant>
 #include <evm/types.h>
+#include <evm/gas_types.h>
 #include <evm/rlp_encode.hpp>
+#include <evm/rlp_decode.hpp>
 #include <evm/hash.hpp>
+#include <evm/keccak_stream.hpp>
 #include <evm/overflow.hpp>
 #include <evm/hex.hpp>
 
+/*
+  A transaction decoded once from its signed encoding. data and fields point into the encoded
+  buffer, which has to outlive the view.
+*/
+struct TransactionView {
+  TransactionActionType type;
+  uint256_t nonce;
+  uint256_t gasPrice;
+  gas_t gas;
+  uint256_t to;
+  uint256_t value;
+  const uint8_t* data;
+  uint64_t dataSize;
+  bytes_t v;
+  bytes_t r;
+  bytes_t s;
+  bool hasSignature;
+  bytes_t signature;
+  bytes_t digest;
+  rlp_view_t fields[9];
+};
+typedef TransactionView transaction_view_t;
+
 class Transaction {
   public:
     static const size_t RLP_NONCE = 0;
@@ -150,6 +176,103 @@ class Transaction {
       return Hash::keccak256(rlpBytes);
     }
 
+    // false when the encoding is not a single list of nine strings with fields of valid size
+    static bool parse(const bytes_t& encoded, transaction_view_t& tx) {
+      RLPReader reader(encoded);
+      rlp_view_t list;
+      if (!reader.next(list) || list.type != RLPType::LIST || list.encodedSize != encoded.size()) return false;
+
+      RLPReader fieldReader(list);
+      size_t count = 0;
+      rlp_view_t field;
+      while (fieldReader.next(field)) {
+        if (count == 9 || field.type != RLPType::STRING || !canonical(field)) return false;
+        tx.fields[count++] = field;
+      }
+      if (fieldReader.isMalformed() || count != 9) return false;
+
+      for (size_t i : { RLP_NONCE, RLP_GAS_PRICE, RLP_GAS_LIMIT, RLP_VALUE, RLP_R, RLP_S }) {
+        if (tx.fields[i].payloadSize > WORD_SIZE) return false;
+      }
+      const rlp_view_t& address = tx.fields[RLP_ADDRESS];
+      if (address.payloadSize != 0 && address.payloadSize != 20) return false;
+
+      tx.type = address.payloadSize == 0 ? TransactionActionType::TRANSACTION_CREATE : TransactionActionType::TRANSACTION_CALL;
+      tx.nonce = word(tx.fields[RLP_NONCE]);
+      tx.gasPrice = word(tx.fields[RLP_GAS_PRICE]);
+      tx.gas = Overflow::uint256Cast(word(tx.fields[RLP_GAS_LIMIT])).first;
+      tx.to = word(address);
+      tx.value = word(tx.fields[RLP_VALUE]);
+      tx.data = tx.fields[RLP_DATA].payload;
+      tx.dataSize = tx.fields[RLP_DATA].payloadSize;
+      tx.v = bytes(tx.fields[RLP_V]);
+      tx.r = bytes(tx.fields[RLP_R]);
+      tx.s = bytes(tx.fields[RLP_S]);
+      tx.hasSignature = tx.r.size() > 0 && tx.s.size() > 0;
+      if (tx.hasSignature && tx.v.size() == 0) return false;
+      if (tx.r.size() > 0) Hex::padWordSize(tx.r);
+      if (tx.s.size() > 0) Hex::padWordSize(tx.s);
+
+      tx.signature.clear();
+      if (tx.hasSignature) {
+        tx.signature.reserve(1 + tx.r.size() + tx.s.size());
+        tx.signature.push_back(eip155Compat(tx.v) + 27);
+        tx.signature.insert(tx.signature.end(), tx.r.begin(), tx.r.end());
+        tx.signature.insert(tx.signature.end(), tx.s.begin(), tx.s.end());
+      }
+      tx.digest = digest(tx, 0x01);
+      return true;
+    }
+
+    /*
+      Hashes the unsigned form [nonce, gasPrice, gas, to, value, data, chainId, "", ""] by
+      splicing the first six fields straight from the signed encoding. parse only accepts
+      canonical fields, so this matches re-encoding them.
+    */
+    static bytes_t digest(const transaction_view_t& tx, uint8_t chainId) {
+      const uint8_t* fields = tx.fields[RLP_NONCE].encoded;
+      uint64_t fieldsSize = tx.fields[RLP_DATA].encoded + tx.fields[RLP_DATA].encodedSize - fields;
+      uint8_t trailer[] = { static_cast<uint8_t>(OFFSET_SHORT_STRING + 1), chainId, OFFSET_SHORT_STRING, OFFSET_SHORT_STRING };
+      size_t trailerStart = chainId < OFFSET_SHORT_STRING ? 1 : 0;
+      uint64_t payloadSize = fieldsSize + sizeof(trailer) - trailerStart;
+
+      KeccakStream stream;
+      if (payloadSize <= 55) {
+        stream.update(static_cast<uint8_t>(OFFSET_SHORT_LIST + payloadSize));
+      } else {
+        uint8_t length[8];
+        uint8_t lengthSize = 0;
+        for (uint64_t remaining = payloadSize; remaining > 0; remaining >>= 8) lengthSize++;
+        for (uint8_t i = 0; i < lengthSize; i++) length[i] = static_cast<uint8_t>(payloadSize >> (8 * (lengthSize - 1 - i)));
+        stream.update(static_cast<uint8_t>(OFFSET_LONG_LIST + lengthSize));
+        stream.update(length, lengthSize);
+      }
+      stream.update(fields, fieldsSize);
+      stream.update(trailer + trailerStart, sizeof(trailer) - trailerStart);
+
+      ethash::hash256 hash = stream.finalize();
+      return bytes_t(&hash.bytes[0], &hash.bytes[32]);
+    }
+
+    // gas a transaction uses before any code runs
+    static gas_t intrinsicGas(const transaction_view_t& tx) {
+      gas_t gas = TX_GAS;
+      if (tx.type == TransactionActionType::TRANSACTION_CREATE) gas += CREATE_GAS;
+      for (uint64_t i = 0; i < tx.dataSize; i++) {
+        gas += tx.data[i] == 0 ? TX_DATA_ZERO_GAS : TX_DATA_NON_ZERO_GAS;
+      }
+      return gas;
+    }
+
+    // value plus gas * gasPrice, and whether that overflowed
+    static std::pair<uint256_t, bool> upfrontCost(const transaction_view_t& tx) {
+      uint256_t gasCost = tx.gasPrice * tx.gas;
+      if (tx.gas != 0 && gasCost / tx.gas != tx.gasPrice) return std::make_pair(0, true);
+      uint256_t cost = gasCost + tx.value;
+      if (cost < tx.value) return std::make_pair(0, true);
+      return std::make_pair(cost, false);
+    }
+
     static bytes_t prefixedBytes(const bytes_t& hash) {
       std::string prefix = "\u0019Ethereum Signed Message:\n" + std::to_string(hash.size());
       bytes_t messagePrefix(prefix.begin(), prefix.end());
@@ -158,6 +281,24 @@ class Transaction {
     }
 
   private:
+    static uint256_t word(const rlp_view_t& field) {
+      return BigInt::fromBigEndianBytes(field.payload, field.payloadSize);
+    }
+
+    // the shortest encoding of the payload, which is the only one re-encoding would produce
+    static bool canonical(const rlp_view_t& field) {
+      if (field.payloadSize == 1 && field.payload[0] < OFFSET_SHORT_STRING) return field.encodedSize == 1;
+      uint64_t headerSize = 1;
+      if (field.payloadSize > 55) {
+        for (uint64_t remaining = field.payloadSize; remaining > 0; remaining >>= 8) headerSize++;
+      }
+      return field.encodedSize == headerSize + field.payloadSize;
+    }
+
+    static bytes_t bytes(const rlp_view_t& field) {
+      return bytes_t(field.payload, field.payload + field.payloadSize);
+    }
+
     static uint8_t eip155Compat(const bytes_t& bytes) {
       uint8_t v = static_cast<uint8_t>(bytes[0]);
       if (v == 27) return 0;
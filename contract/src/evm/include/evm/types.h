@@ -17,7 +17,7 @@ struct InstructionValue {
 };
 
 typedef InstructionValue instruct_t; 
-typedef std::set<uint64_t> jump_set_t;
+typedef std::vector<uint64_t> jump_map_t;
 
 typedef std::array<uint8_t, 32> address_t;
 typedef std::vector<uint8_t> bytes_t;
@@ -34,6 +34,7 @@ constexpr uint256_t UINT256_ZERO = uint256_t(0);
 constexpr uint256_t UINT256_32 = uint256_t(32);
 constexpr uint256_t UINT256_FF = uint256_t(0xff);
 constexpr uint256_t UINT256_ONE = uint256_t(1);
+constexpr uint256_t EMPTY_CODE_HASH = intx::from_string<uint256_t>("0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470");
 
 const uint8_t OFFSET_SHORT_STRING = 0x80;
 const uint8_t OFFSET_LONG_STRING = 0xb7;
@@ -101,7 +102,8 @@ enum TrapKind {
   TRAP_INSUFFICIENT_FUNDS,
   TRAP_INVALID_CODE_ADDRESS,
   TRAP_OVERFLOW,
-  TRAP_MUTATE_STATIC
+  TRAP_MUTATE_STATIC,
+  TRAP_PRECOMPILE_FAILED
 };
 
 typedef TrapKind trap_t;
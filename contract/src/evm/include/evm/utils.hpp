@@ -5,6 +5,7 @@
 #include <evm/vm_result.h>
 #include <evm/gasometer.hpp>
 #include <evm/hex.hpp>
+#include <evm/jumps.hpp>
 
 enum GasTierPrice: uint8_t {
   ZERO = 0x00,
@@ -99,9 +100,10 @@ class Utils {
       printf("%s{%s}\n", key.c_str(), Hex::bytesToHex(value).c_str());
     }
 
-    static void printJumps(const jump_set_t& jumps) {
-      printf("jumpsize{%zu}\n", jumps.size());
-      for(uint64_t jump : jumps) {
+    static void printJumps(const jump_map_t& jumps) {
+      std::vector<uint64_t> destinations = Jumps::destinations(jumps);
+      printf("jumpsize{%zu}\n", destinations.size());
+      for(uint64_t jump : destinations) {
         printf("jump(%llu)\n", jump);
       }   
     }
@@ -630,6 +632,9 @@ class Utils {
         case TrapKind::TRAP_MUTATE_STATIC:
           printf("trap{mutate_static}\n");
           break;
+        case TrapKind::TRAP_PRECOMPILE_FAILED:
+          printf("trap{precompile_failed}\n");
+          break;
       }
     }
     
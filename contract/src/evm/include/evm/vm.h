@@ -10,6 +10,7 @@
 #include <evm/gasometer.hpp>
 #include <evm/context.hpp>
 #include <evm/operation.hpp>
+#include <evm/execution_state.hpp>
 
 class VM {
   public:
@@ -19,7 +20,6 @@ class VM {
     ) {
       stack = stackArg;
       gasometer = gasometerArg;
-      returnData = bytes_t();
     };
     exec_result_t execute(
       uint16_t stackDepth,
@@ -30,41 +30,32 @@ class VM {
       std::shared_ptr<PendingState> pendingState,
       std::shared_ptr<External> external
     );
-    exec_result_t step(
-      uint16_t stackDepth,
-      jump_set_t& jumps, 
-      std::shared_ptr<Context> context,
-      std::shared_ptr<Memory> memory,
-      std::shared_ptr<ByteReader> reader,
-      std::shared_ptr<Operation> operation,
-      std::shared_ptr<GasCalculation> gasCalculation,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external
+    static exec_result_t execute(
+      ExecutionState& state,
+      Operation& operation,
+      GasCalculation& gasCalculation
     );
-    instruction_result_t executeCreateInstruction(
-      uint16_t stackDepth,
+    static exec_result_t step(
+      ExecutionState& state,
+      const jump_map_t& jumps,
+      Operation& operation,
+      GasCalculation& gasCalculation
+    );
+    static instruction_result_t executeCreateInstruction(
+      ExecutionState& state,
       uint8_t opcode,
       gas_t providedGas,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<Memory> memory,
-      std::shared_ptr<Operation> operation,
-      std::shared_ptr<GasCalculation> gasCalculation,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external
+      Operation& operation,
+      GasCalculation& gasCalculation
     );
-    instruction_result_t executeCallInstruction(
-      uint16_t stackDepth,
+    static instruction_result_t executeCallInstruction(
+      ExecutionState& state,
       uint8_t opcode,
       gas_t providedGas,
-      std::shared_ptr<Context> context,
-      std::shared_ptr<Memory> memory,
-      std::shared_ptr<Operation> operation,
-      std::shared_ptr<GasCalculation> gasCalculation,
-      std::shared_ptr<PendingState> pendingState,
-      std::shared_ptr<External> external
+      Operation& operation,
+      GasCalculation& gasCalculation
     );
     std::shared_ptr<StackMachine> stack;
   private:
     std::shared_ptr<Gasometer> gasometer;
-    bytes_t returnData;
 };
\ No newline at end of file
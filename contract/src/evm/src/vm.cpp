@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <evm/vm.h>
 #include <evm/opcode.h>
 #include <evm/address.hpp>
@@ -11,8 +12,140 @@
 #include <evm/gas_calculation.hpp>
 #include <evm/gas_types.h>
 #include <evm/call.hpp>
+#include <evm/precompile.hpp>
 #include <evm/utils.hpp>
 
+/*
+  Opcodes with a fixed cost and no side effects outside the stack are run inline by
+  VM::execute; they map to their own handler. Everything else goes through VM::step.
+*/
+enum Handler : uint8_t {
+  HANDLER_GENERIC,
+  HANDLER_STOP,
+  HANDLER_ADD,
+  HANDLER_MUL,
+  HANDLER_SUB,
+  HANDLER_DIV,
+  HANDLER_MOD,
+  HANDLER_LT,
+  HANDLER_GT,
+  HANDLER_EQ,
+  HANDLER_ISZERO,
+  HANDLER_AND,
+  HANDLER_OR,
+  HANDLER_XOR,
+  HANDLER_NOT,
+  HANDLER_SHL,
+  HANDLER_SHR,
+  HANDLER_POP,
+  HANDLER_JUMP,
+  HANDLER_JUMPI,
+  HANDLER_PC,
+  HANDLER_GAS,
+  HANDLER_JUMPDEST,
+  HANDLER_PUSH,
+  HANDLER_DUP,
+  HANDLER_SWAP
+};
+
+static constexpr std::array<uint8_t, 256> makeHandlers() {
+  std::array<uint8_t, 256> handlers {};
+  handlers[Opcode::STOP] = HANDLER_STOP;
+  handlers[Opcode::ADD] = HANDLER_ADD;
+  handlers[Opcode::MUL] = HANDLER_MUL;
+  handlers[Opcode::SUB] = HANDLER_SUB;
+  handlers[Opcode::DIV] = HANDLER_DIV;
+  handlers[Opcode::MOD] = HANDLER_MOD;
+  handlers[Opcode::LT] = HANDLER_LT;
+  handlers[Opcode::GT] = HANDLER_GT;
+  handlers[Opcode::EQ] = HANDLER_EQ;
+  handlers[Opcode::ISZERO] = HANDLER_ISZERO;
+  handlers[Opcode::AND] = HANDLER_AND;
+  handlers[Opcode::OR] = HANDLER_OR;
+  handlers[Opcode::XOR] = HANDLER_XOR;
+  handlers[Opcode::NOT] = HANDLER_NOT;
+  handlers[Opcode::SHL] = HANDLER_SHL;
+  handlers[Opcode::SHR] = HANDLER_SHR;
+  handlers[Opcode::POP] = HANDLER_POP;
+  handlers[Opcode::JUMP] = HANDLER_JUMP;
+  handlers[Opcode::JUMPI] = HANDLER_JUMPI;
+  handlers[Opcode::PC] = HANDLER_PC;
+  handlers[Opcode::GAS] = HANDLER_GAS;
+  handlers[Opcode::JUMPDEST] = HANDLER_JUMPDEST;
+  for (int op = Opcode::PUSH1; op <= Opcode::PUSH32; op++) handlers[op] = HANDLER_PUSH;
+  for (int op = Opcode::DUP1; op <= Opcode::DUP16; op++) handlers[op] = HANDLER_DUP;
+  for (int op = Opcode::SWAP1; op <= Opcode::SWAP16; op++) handlers[op] = HANDLER_SWAP;
+  return handlers;
+}
+
+static constexpr std::array<uint8_t, 256> HANDLERS = makeHandlers();
+
+static constexpr bool handlersMatchBlocks() {
+  for (int op = 0; op < 256; op++) {
+    if ((HANDLERS[op] != HANDLER_GENERIC) != CodeAnalysis::isBlockInstruction(op)) return false;
+  }
+  return true;
+}
+
+// basic blocks are prepaid, so they may only hold instructions that never reach VM::step
+static_assert(handlersMatchBlocks(), "inline handlers and basic block instructions differ");
+
+// labels as values are a GNU extension, define EVM_SWITCH_DISPATCH to force the portable switch
+#if defined(__GNUC__) && !defined(EVM_SWITCH_DISPATCH)
+#define EVM_COMPUTED_GOTO
+#endif
+
+#ifdef EVM_COMPUTED_GOTO
+#define TARGET(handler) TARGET_##handler: case HANDLER_##handler:
+#define DISPATCH() { FETCH(); goto *labels[HANDLERS[opcode]]; }
+#else
+#define TARGET(handler) case HANDLER_##handler:
+#define DISPATCH() continue
+#endif
+
+#define EXIT(result) { state.gasometer.currentGas = gas; return result; }
+
+/*
+  Entering a basic block charges its gas and checks its stack bounds at once. Blocks are only
+  prepaid when gas stays above zero, otherwise every instruction is metered on its own so that
+  out of gas and stack traps happen at the same instruction.
+*/
+#define ENTER_BLOCK() \
+  metered = true; \
+  while (nextBlock < blocks.size() && blocks[nextBlock].start < pc) nextBlock++; \
+  if (nextBlock < blocks.size() && blocks[nextBlock].start == pc) { \
+    const basic_block_t& block = blocks[nextBlock++]; \
+    int64_t height = items.size(); \
+    if (block.gas < gas && height + block.stackMin >= 0 && height + block.stackMax <= int64_t(STACK_LIMIT)) { \
+      gas -= block.gas; \
+      blockEnd = block.end; \
+      metered = false; \
+    } \
+  }
+
+#define FETCH() \
+  if (pc >= codeSize) EXIT(std::make_pair(ExecResult::DONE_VOID, gas)); \
+  if (pc >= blockEnd) { ENTER_BLOCK(); } \
+  if (gas == 0) EXIT(std::make_pair(ExecResult::VM_OUT_OF_GAS, 0)); \
+  opcode = code[pc];
+
+#define CHECK_STACK(instruction) \
+  if (items.size() < instruction.args) EXIT(std::make_pair(ExecResult::VM_TRAP, TrapKind::TRAP_STACK_UNDERFLOW)); \
+  if (items.size() - instruction.args + instruction.ret > STACK_LIMIT) EXIT(std::make_pair(ExecResult::VM_TRAP, TrapKind::TRAP_OUT_OF_STACK));
+
+#define JUMP_TO(position) \
+  pc = position; \
+  blockEnd = 0; \
+  nextBlock = analysis->findBlock(position);
+
+#define CHARGE(cost) gas = Overflow::sub(gas, cost).first;
+
+#define CHECK_AND_CHARGE(op) \
+  if (metered) { \
+    CHECK_STACK(Instruction::values[op]) \
+    CHARGE(TIER_STEP_GAS[Instruction::values[op].tier]) \
+  }
+
 exec_result_t VM::execute(
   uint16_t stackDepth,
   std::shared_ptr<Context> context,
@@ -22,51 +155,286 @@ exec_result_t VM::execute(
   std::shared_ptr<PendingState> pendingState,
   std::shared_ptr<External> external
 ) {
+  ExecutionState state(stackDepth, *context, *memory, *stack, *gasometer, pendingState, external);
+  return VM::execute(state, *operation, *gasCalculation);
+}
 
-  exec_result_t result;
-
-  jump_set_t jumps = Jumps::findDestinations(context->code);
-  std::shared_ptr<ByteReader> reader = std::make_shared<ByteReader>(0);
-
-  do {
-    result = VM::step(
-      stackDepth,
-      jumps, 
-      context,
-      memory, 
-      reader, 
-      operation,
-      gasCalculation,
-      pendingState, 
-      external
-    );
-  } while(result.first == ExecResult::CONTINUE);
+exec_result_t VM::execute(
+  ExecutionState& state,
+  Operation& operation,
+  GasCalculation& gasCalculation
+) {
 
-  return result;
+  std::shared_ptr<CodeAnalysis> analysis = state.pendingState->codeAnalysis.get(state.context.codeHash, state.context.code);
+
+  const uint8_t* code = state.context.code->data();
+  const uint64_t codeSize = state.context.code->size();
+  std::vector<uint256_t>& items = state.stack.stack;
+
+  const std::vector<basic_block_t>& blocks = analysis->blocks;
+
+  uint64_t pc = 0;
+  gas_t gas = state.gasometer.currentGas;
+  uint8_t opcode;
+
+  size_t nextBlock = 0;
+  uint64_t blockEnd = 0;
+  bool metered = true;
+
+  if (gas == 0) return std::make_pair(ExecResult::VM_OUT_OF_GAS, 0);
+
+#ifdef EVM_COMPUTED_GOTO
+  static void* const labels[] = {
+    &&TARGET_GENERIC,
+    &&TARGET_STOP,
+    &&TARGET_ADD,
+    &&TARGET_MUL,
+    &&TARGET_SUB,
+    &&TARGET_DIV,
+    &&TARGET_MOD,
+    &&TARGET_LT,
+    &&TARGET_GT,
+    &&TARGET_EQ,
+    &&TARGET_ISZERO,
+    &&TARGET_AND,
+    &&TARGET_OR,
+    &&TARGET_XOR,
+    &&TARGET_NOT,
+    &&TARGET_SHL,
+    &&TARGET_SHR,
+    &&TARGET_POP,
+    &&TARGET_JUMP,
+    &&TARGET_JUMPI,
+    &&TARGET_PC,
+    &&TARGET_GAS,
+    &&TARGET_JUMPDEST,
+    &&TARGET_PUSH,
+    &&TARGET_DUP,
+    &&TARGET_SWAP
+  };
+#endif
+
+  for (;;) {
+    FETCH();
+
+    switch (HANDLERS[opcode]) {
+      TARGET(STOP) {
+        EXIT(std::make_pair(ExecResult::DONE_VOID, gas));
+      }
+      TARGET(ADD) {
+        CHECK_AND_CHARGE(Opcode::ADD);
+        items[items.size() - 2] = items[items.size() - 1] + items[items.size() - 2];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(MUL) {
+        CHECK_AND_CHARGE(Opcode::MUL);
+        items[items.size() - 2] = items[items.size() - 1] * items[items.size() - 2];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(SUB) {
+        CHECK_AND_CHARGE(Opcode::SUB);
+        items[items.size() - 2] = items[items.size() - 1] - items[items.size() - 2];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(DIV) {
+        CHECK_AND_CHARGE(Opcode::DIV);
+        uint256_t& b = items[items.size() - 2];
+        b = b == 0 ? UINT256_ZERO : items[items.size() - 1] / b;
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(MOD) {
+        CHECK_AND_CHARGE(Opcode::MOD);
+        uint256_t& b = items[items.size() - 2];
+        b = b == 0 ? UINT256_ZERO : items[items.size() - 1] % b;
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(LT) {
+        CHECK_AND_CHARGE(Opcode::LT);
+        items[items.size() - 2] = items[items.size() - 1] < items[items.size() - 2] ? UINT256_ONE : UINT256_ZERO;
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(GT) {
+        CHECK_AND_CHARGE(Opcode::GT);
+        items[items.size() - 2] = items[items.size() - 1] > items[items.size() - 2] ? UINT256_ONE : UINT256_ZERO;
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(EQ) {
+        CHECK_AND_CHARGE(Opcode::EQ);
+        items[items.size() - 2] = items[items.size() - 1] == items[items.size() - 2] ? UINT256_ONE : UINT256_ZERO;
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(ISZERO) {
+        CHECK_AND_CHARGE(Opcode::ISZERO);
+        items.back() = items.back() == UINT256_ZERO ? UINT256_ONE : UINT256_ZERO;
+        pc++;
+        DISPATCH();
+      }
+      TARGET(AND) {
+        CHECK_AND_CHARGE(Opcode::AND);
+        items[items.size() - 2] = items[items.size() - 1] & items[items.size() - 2];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(OR) {
+        CHECK_AND_CHARGE(Opcode::OR);
+        items[items.size() - 2] = items[items.size() - 1] | items[items.size() - 2];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(XOR) {
+        CHECK_AND_CHARGE(Opcode::XOR);
+        items[items.size() - 2] = items[items.size() - 1] ^ items[items.size() - 2];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(NOT) {
+        CHECK_AND_CHARGE(Opcode::NOT);
+        items.back() = ~items.back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(SHL) {
+        CHECK_AND_CHARGE(Opcode::SHL);
+        items[items.size() - 2] <<= items[items.size() - 1];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(SHR) {
+        CHECK_AND_CHARGE(Opcode::SHR);
+        items[items.size() - 2] >>= items[items.size() - 1];
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(POP) {
+        CHECK_AND_CHARGE(Opcode::POP);
+        items.pop_back();
+        pc++;
+        DISPATCH();
+      }
+      TARGET(JUMP) {
+        CHECK_AND_CHARGE(Opcode::JUMP);
+        uint64_t position = Overflow::uint256Cast(items.back()).first;
+        items.pop_back();
+        if (!analysis->isJumpDestination(position)) EXIT(std::make_pair(ExecResult::VM_TRAP, TrapKind::TRAP_INVALID_JUMP));
+        JUMP_TO(position);
+        DISPATCH();
+      }
+      TARGET(JUMPI) {
+        CHECK_AND_CHARGE(Opcode::JUMPI);
+        bool condition = items[items.size() - 2] == UINT256_ONE;
+        uint64_t position = Overflow::uint256Cast(items.back()).first;
+        items.pop_back();
+        items.pop_back();
+        if (condition) {
+          if (!analysis->isJumpDestination(position)) EXIT(std::make_pair(ExecResult::VM_TRAP, TrapKind::TRAP_INVALID_JUMP));
+          JUMP_TO(position);
+        } else {
+          pc++;
+        }
+        DISPATCH();
+      }
+      TARGET(PC) {
+        CHECK_AND_CHARGE(Opcode::PC);
+        items.push_back(uint256_t(pc));
+        pc++;
+        DISPATCH();
+      }
+      TARGET(GAS) {
+        CHECK_AND_CHARGE(Opcode::GAS);
+        items.push_back(uint256_t(gas));
+        pc++;
+        DISPATCH();
+      }
+      TARGET(JUMPDEST) {
+        if (metered) { CHARGE(JUMPDEST_GAS) }
+        pc++;
+        DISPATCH();
+      }
+      TARGET(PUSH) {
+        CHECK_AND_CHARGE(opcode);
+        // a push truncated by the end of the code keeps its bytes right aligned
+        uint64_t size = opcode - Opcode::PUSH1 + 1;
+        uint64_t available = std::min(size, codeSize - pc - 1);
+        uint8_t data[WORD_SIZE] = {};
+        std::copy(code + pc + 1, code + pc + 1 + available, data + WORD_SIZE - available);
+        items.push_back(intx::be::load<uint256_t>(data));
+        pc += size + 1;
+        DISPATCH();
+      }
+      TARGET(DUP) {
+        CHECK_AND_CHARGE(opcode);
+        uint256_t item = items[items.size() - (opcode - Opcode::DUP1) - 1];
+        items.push_back(item);
+        pc++;
+        DISPATCH();
+      }
+      TARGET(SWAP) {
+        CHECK_AND_CHARGE(opcode);
+        std::swap(items[items.size() - 1], items[items.size() - (opcode - Opcode::SWAP1) - 2]);
+        pc++;
+        DISPATCH();
+      }
+      TARGET(GENERIC) {
+        state.gasometer.currentGas = gas;
+        state.reader.move(pc);
+        exec_result_t result = VM::step(state, analysis->jumps, operation, gasCalculation);
+        if (result.first != ExecResult::CONTINUE) return result;
+        gas = state.gasometer.currentGas;
+        pc = state.reader.offset();
+        DISPATCH();
+      }
+    }
+  }
 }
 
+#undef TARGET
+#undef DISPATCH
+#undef EXIT
+#undef FETCH
+#undef CHECK_STACK
+#undef CHARGE
+#undef JUMP_TO
+#undef ENTER_BLOCK
+#undef CHECK_AND_CHARGE
+
 exec_result_t VM::step(
-  uint16_t stackDepth,
-  jump_set_t& jumps, 
-  std::shared_ptr<Context> context,
-  std::shared_ptr<Memory> memory,
-  std::shared_ptr<ByteReader> reader, 
-  std::shared_ptr<Operation> operation,
-  std::shared_ptr<GasCalculation> gasCalculation,
-  std::shared_ptr<PendingState> pendingState,
-  std::shared_ptr<External> external
+  ExecutionState& state,
+  const jump_map_t& jumps,
+  Operation& operation,
+  GasCalculation& gasCalculation
 ) {
 
-  if (gasometer->currentGas == 0) {
+  if (state.gasometer.currentGas == 0) {
     return std::make_pair(ExecResult::VM_OUT_OF_GAS, 0);
-  } else if (context->code->size() == 0) {
-    return std::make_pair(ExecResult::DONE_VOID, gasometer->currentGas);
+  } else if (state.context.code->size() == 0) {
+    return std::make_pair(ExecResult::DONE_VOID, state.gasometer.currentGas);
   } else {
-    uint8_t opcode = reader->currentOp(context->code);
+    uint8_t opcode = state.reader.currentOp(state.context.code);
     instruct_t instruction = Instruction::values[opcode];
-    reader->next();
+    state.reader.next();
 
-    instruction_verify_t verifyResult = Instruction::verify(instruction, stack->size());
+    instruction_verify_t verifyResult = Instruction::verify(instruction, state.stack.size());
     switch (verifyResult) {
       case InstructionVerifyResult::INSTRUCTION_ERROR_UNDER_FLOW:
         return std::make_pair(ExecResult::VM_TRAP, TrapKind::TRAP_STACK_UNDERFLOW);
@@ -78,15 +446,13 @@ exec_result_t VM::step(
         break;
     }
 
-    uint64_t memoryLength = memory->length();
-    instruction_requirements_t calculateRequirements = gasometer->requirements(
+    uint64_t memoryLength = state.memory.length();
+    instruction_requirements_t calculateRequirements = state.gasometer.requirements(
       opcode,
       instruction, 
       memoryLength,
       gasCalculation,
-      context,
-      stack, 
-      external
+      state
     );
 
     GasRequirements requirements;
@@ -100,13 +466,13 @@ exec_result_t VM::step(
 
     // expand memory
     gas_t memoryRequiredSize = requirements.memoryRequiredSize;
-    memory->expand(memoryRequiredSize);
+    state.memory.expand(memoryRequiredSize);
     
-    gas_t currentGas = Overflow::sub(gasometer->currentGas, requirements.gasCost).first;
-    gasometer->currentGas = currentGas;
+    gas_t currentGas = Overflow::sub(state.gasometer.currentGas, requirements.gasCost).first;
+    state.gasometer.currentGas = currentGas;
 
     gas_t memoryTotalGas = requirements.memoryTotalGas;
-    gasometer->currentMemGas = memoryTotalGas;
+    state.gasometer.currentMemGas = memoryTotalGas;
 
     gas_t provideGas = requirements.provideGas;
 
@@ -114,45 +480,41 @@ exec_result_t VM::step(
     switch (opcode) {
       case Opcode::RETURNDATASIZE:
         {
-          uint256_t returnDataSize = uint256_t(returnData.size());
-          stack->push(returnDataSize);
+          uint256_t returnDataSize = uint256_t(state.returnData.size());
+          state.stack.push(returnDataSize);
           result = std::make_pair(InstructionResult::OK, 0);
           break;
         }
       case Opcode::RETURNDATACOPY:
         {
-          uint64_t sourceOffset = Overflow::uint256Cast(stack->peek(1)).first;
-          uint64_t sizeItem = Overflow::uint256Cast(stack->peek(2)).first;
+          uint64_t sourceOffset = Overflow::uint256Cast(state.stack.peek(1)).first;
+          uint64_t sizeItem = Overflow::uint256Cast(state.stack.peek(2)).first;
 
-          uint64_t returnDataLength = returnData.size();
+          uint64_t returnDataLength = state.returnData.size();
 
           if (Overflow::add(sourceOffset, sizeItem).first > returnDataLength) {
             result = std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_OVERFLOW);
           } else {
-            memory->copyData(
-              Overflow::uint256Cast(stack->peek(0)).first, 
+            state.memory.copyData(
+              Overflow::uint256Cast(state.stack.peek(0)).first, 
               sourceOffset, 
               sizeItem, 
-              returnData
+              state.returnData
             );
             result = std::make_pair(InstructionResult::OK, 0);
           }
-          stack->pop(3);
+          state.stack.pop(3);
           break;
         }
       case Opcode::CREATE:
       case Opcode::CREATE2:
         {
           result = executeCreateInstruction(
-            stackDepth,
+            state,
             opcode,
             requirements.provideGas,
-            context,
-            memory,
             operation,
-            gasCalculation,
-            pendingState,
-            external
+            gasCalculation
           );
           break;
         }
@@ -162,30 +524,21 @@ exec_result_t VM::step(
       case Opcode::STATICCALL:
         {
           result = executeCallInstruction(
-            stackDepth,
+            state,
             opcode,
             requirements.provideGas,
-            context,
-            memory,
             operation,
-            gasCalculation,
-            pendingState,
-            external
+            gasCalculation
           );
           break;
         }
       default:
         result = std::invoke(
-          operation->values[opcode], 
+          operation.values[opcode], 
           operation, 
           currentGas,
           instruction, 
-          context, 
-          reader, 
-          pendingState,
-          external, 
-          memory, 
-          stack
+          state
         );
     }
 
@@ -197,7 +550,7 @@ exec_result_t VM::step(
       case InstructionResult::UNUSED_GAS:
         {
           gas_t gasLeft = std::get<gas_t>(result.second);
-          gasometer->currentGas = gasometer->currentGas + gasLeft;
+          state.gasometer.currentGas = state.gasometer.currentGas + gasLeft;
           break;
         }
       case InstructionResult::JUMP_POSITION:
@@ -205,7 +558,7 @@ exec_result_t VM::step(
           uint64_t position = std::get<uint64_t>(result.second);
           uint64_t pos = Jumps::verifyJump(position, jumps);
           if (pos == INVALID_ARGUMENT) return std::make_pair(ExecResult::VM_TRAP, TrapKind::TRAP_INVALID_JUMP);
-          reader->move(pos);
+          state.reader.move(pos);
           break;
         }
       case InstructionResult::STOP_EXEC_RETURN:
@@ -223,7 +576,7 @@ exec_result_t VM::step(
           return std::make_pair(ExecResult::DONE_RETURN, needsReturn);
         }
       case InstructionResult::STOP_EXEC:
-        return std::make_pair(ExecResult::DONE_VOID, gasometer->currentGas);
+        return std::make_pair(ExecResult::DONE_VOID, state.gasometer.currentGas);
       case InstructionResult::INSTRUCTION_TRAP:
         {
           trap_t trap = std::get<trap_t>(result.second);
@@ -231,22 +584,18 @@ exec_result_t VM::step(
         }
     }
     
-    if (reader->atEnd(context->code)) return std::make_pair(ExecResult::DONE_VOID, gasometer->currentGas);
+    if (state.reader.atEnd(state.context.code)) return std::make_pair(ExecResult::DONE_VOID, state.gasometer.currentGas);
 
     return std::make_pair(ExecResult::CONTINUE, 0);
   }
 }
 
 instruction_result_t VM::executeCreateInstruction(
-  uint16_t stackDepth,
+  ExecutionState& state,
   uint8_t opcode,
   gas_t providedGas,
-  std::shared_ptr<Context> context,
-  std::shared_ptr<Memory> memory,
-  std::shared_ptr<Operation> operation,
-  std::shared_ptr<GasCalculation> gasCalculation,
-  std::shared_ptr<PendingState> pendingState,
-  std::shared_ptr<External> external
+  Operation& operation,
+  GasCalculation& gasCalculation
 ) {
   uint256_t endowment;
   uint64_t initOff;
@@ -254,101 +603,101 @@ instruction_result_t VM::executeCreateInstruction(
 
   AddressScheme addressScheme; 
   uint256_t salt;
-  uint256_t parentNonce = external->incrementContractNonce(context->address);
+  uint256_t parentNonce = state.external->incrementContractNonce(state.context.address);
 
   switch (opcode) {
     case Opcode::CREATE:
       {
         addressScheme = AddressScheme::LEGACY;
-        endowment = stack->peek(0);
-        initOff = Overflow::uint256Cast(stack->peek(1)).first;
-        initSize = Overflow::uint256Cast(stack->peek(2)).first;
+        endowment = state.stack.peek(0);
+        initOff = Overflow::uint256Cast(state.stack.peek(1)).first;
+        initSize = Overflow::uint256Cast(state.stack.peek(2)).first;
         salt = parentNonce;
-        stack->pop(3);
+        state.stack.pop(3);
         break;
       }
     case Opcode::CREATE2:
       {
-        endowment = stack->peek(0);
-        initOff = Overflow::uint256Cast(stack->peek(1)).first;
-        initSize = Overflow::uint256Cast(stack->peek(2)).first;
-        salt = stack->peek(3); 
+        endowment = state.stack.peek(0);
+        initOff = Overflow::uint256Cast(state.stack.peek(1)).first;
+        initSize = Overflow::uint256Cast(state.stack.peek(2)).first;
+        salt = state.stack.peek(3); 
         addressScheme = AddressScheme::EIP_1014;
-        stack->pop(4);
+        state.stack.pop(4);
         break;
       }
   }
 
   gas_t createGas = providedGas;
 
-  returnData.clear();
+  state.returnData.clear();
 
-  if (stackDepth > STACK_LIMIT) {
-    stack->push(UINT256_ZERO);
+  if (state.stackDepth > STACK_LIMIT) {
+    state.stack.push(UINT256_ZERO);
     return std::make_pair(InstructionResult::UNUSED_GAS, createGas);
   }
 
-  if (context->isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
+  if (state.context.isStatic) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
 
-  std::shared_ptr<bytes_t> createCode = std::make_shared<bytes_t>(memory->readSlice(initOff, initSize));
+  std::shared_ptr<bytes_t> createCode = std::make_shared<bytes_t>(state.memory.readSlice(initOff, initSize));
 
   uint256_t codeAddress = Address::makeCreateAddress(
     addressScheme,
-    context->sender,
+    state.context.sender,
     salt,
     createCode
   );
 
-  std::shared_ptr<Context> createContext = Context::makeInnerCreate(
-    context,
+  Context createContext = Context::makeInnerCreate(
+    state.context,
     codeAddress, 
     createGas, 
     endowment,  
     createCode
   );
 
-  std::shared_ptr<Memory> createMemory = std::make_shared<Memory>();
+  Memory& createMemory = state.pendingState->frames.memory(state.stackDepth + 1);
 
   call_result_t callResult = Call::call(
-    stackDepth,
+    state.stackDepth,
     CallType::ACTION_CREATE,
     createMemory,
     createContext,
     operation,
     gasCalculation,
-    external,
-    pendingState
+    state.external,
+    state.pendingState
   );
 
   switch (callResult.first) {
     case MESSAGE_CALL_SUCCESS:
       {
-        stack->push(UINT256_ONE);
+        state.stack.push(UINT256_ONE);
         gas_t gasLeft = std::get<gas_t>(callResult.second);
         return std::make_pair(InstructionResult::UNUSED_GAS, gasLeft);
       }
     case MESSAGE_CALL_RETURN:
       {
         MessageCallReturn callReturn = std::get<MessageCallReturn>(callResult.second);
-        bytes_t returnDataBytes = createMemory->readSlice(callReturn.offset, callReturn.size);
+        bytes_t returnDataBytes = createMemory.readSlice(callReturn.offset, callReturn.size);
 
         uint256_t returnDataCost = uint256_t(returnDataBytes.size()) * uint256_t(CREATE_DATA_GAS);
         if (returnDataCost > callReturn.gasLeft || returnDataBytes.size() > MAX_CONTRACT_SIZE) {
           return std::make_pair(InstructionResult::OUT_OF_GAS, 0);
         }
 
-        emplace_t emplaceResult = external->emplaceCode(
-          context->address, 
+        emplace_t emplaceResult = state.external->emplaceCode(
+          state.context.address, 
           codeAddress,
           endowment, 
           returnDataBytes,
-          pendingState
+          state.pendingState
         );
 
         switch (emplaceResult.first) {
           case EmplaceResult::EMPLACE_SUCCESS:
             {
-              stack->push(codeAddress);
+              state.stack.push(codeAddress);
               return std::make_pair(
                 InstructionResult::UNUSED_GAS, 
                 callReturn.gasLeft - Overflow::uint256Cast(returnDataCost).first
@@ -359,7 +708,7 @@ instruction_result_t VM::executeCreateInstruction(
             return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_INVALID_CODE_ADDRESS);
           case EmplaceResult::EMPLACE_INSUFFICIENT_FUNDS:
             {
-              stack->push(UINT256_ZERO);
+              state.stack.push(UINT256_ZERO);
               return std::make_pair(InstructionResult::UNUSED_GAS, callReturn.gasLeft);
             }
         }
@@ -367,8 +716,8 @@ instruction_result_t VM::executeCreateInstruction(
     case MESSAGE_CALL_REVERTED:
       {
         MessageCallReturn callReturn = std::get<MessageCallReturn>(callResult.second);
-        stack->push(UINT256_ZERO);
-        returnData = createMemory->readSlice(callReturn.offset, callReturn.size);
+        state.stack.push(UINT256_ZERO);
+        state.returnData = createMemory.readSlice(callReturn.offset, callReturn.size);
         return std::make_pair(
           InstructionResult::UNUSED_GAS,
           callReturn.gasLeft
@@ -376,12 +725,12 @@ instruction_result_t VM::executeCreateInstruction(
       }
     case MESSAGE_CALL_OUT_OF_GAS:
     {
-        stack->push(UINT256_ZERO);
+        state.stack.push(UINT256_ZERO);
         return std::make_pair(InstructionResult::OK, 0);      
     }
     case MESSAGE_CALL_FAILED:
       {
-        stack->push(UINT256_ZERO);
+        state.stack.push(UINT256_ZERO);
         return std::make_pair(InstructionResult::OK, 0);
       }
   }
@@ -390,19 +739,15 @@ instruction_result_t VM::executeCreateInstruction(
 }
 
 instruction_result_t VM::executeCallInstruction(
-  uint16_t stackDepth,
+  ExecutionState& state,
   uint8_t opcode,
   gas_t providedGas,
-  std::shared_ptr<Context> context,
-  std::shared_ptr<Memory> memory,
-  std::shared_ptr<Operation> operation,
-  std::shared_ptr<GasCalculation> gasCalculation,
-  std::shared_ptr<PendingState> pendingState,
-  std::shared_ptr<External> external
+  Operation& operation,
+  GasCalculation& gasCalculation
 ) {
-  uint256_t codeAddress = stack->peek(1);
+  uint256_t codeAddress = state.stack.peek(1);
   uint256_t value = 0; 
-  bool isStatic = context->isStatic;
+  bool isStatic = state.context.isStatic;
   uint64_t inOffset;
   uint64_t inSize;
   uint64_t outOffset;
@@ -411,31 +756,31 @@ instruction_result_t VM::executeCallInstruction(
   switch (opcode) {
     case Opcode::DELEGATECALL:
       {
-        inOffset = Overflow::uint256Cast(stack->peek(2)).first;
-        inSize = Overflow::uint256Cast(stack->peek(3)).first;
-        outOffset = Overflow::uint256Cast(stack->peek(4)).first;
-        outSize = Overflow::uint256Cast(stack->peek(5)).first;
-        stack->pop(6);
+        inOffset = Overflow::uint256Cast(state.stack.peek(2)).first;
+        inSize = Overflow::uint256Cast(state.stack.peek(3)).first;
+        outOffset = Overflow::uint256Cast(state.stack.peek(4)).first;
+        outSize = Overflow::uint256Cast(state.stack.peek(5)).first;
+        state.stack.pop(6);
         break;
       }
     case Opcode::STATICCALL:
       {
         isStatic = true;
-        inOffset = Overflow::uint256Cast(stack->peek(2)).first;
-        inSize = Overflow::uint256Cast(stack->peek(3)).first;
-        outOffset = Overflow::uint256Cast(stack->peek(4)).first;
-        outSize = Overflow::uint256Cast(stack->peek(5)).first;
-        stack->pop(6);
+        inOffset = Overflow::uint256Cast(state.stack.peek(2)).first;
+        inSize = Overflow::uint256Cast(state.stack.peek(3)).first;
+        outOffset = Overflow::uint256Cast(state.stack.peek(4)).first;
+        outSize = Overflow::uint256Cast(state.stack.peek(5)).first;
+        state.stack.pop(6);
         break;
       }
     default:
       {
-        value = stack->peek(2);
-        inOffset = Overflow::uint256Cast(stack->peek(3)).first;
-        inSize = Overflow::uint256Cast(stack->peek(4)).first;
-        outOffset = Overflow::uint256Cast(stack->peek(5)).first;
-        outSize = Overflow::uint256Cast(stack->peek(6)).first;
-        stack->pop(7);
+        value = state.stack.peek(2);
+        inOffset = Overflow::uint256Cast(state.stack.peek(3)).first;
+        inSize = Overflow::uint256Cast(state.stack.peek(4)).first;
+        outOffset = Overflow::uint256Cast(state.stack.peek(5)).first;
+        outSize = Overflow::uint256Cast(state.stack.peek(6)).first;
+        state.stack.pop(7);
         break;
       }
   }
@@ -450,34 +795,34 @@ instruction_result_t VM::executeCallInstruction(
     case Opcode::CALL:
       {
         if (isStatic && value > 0) return std::make_pair(InstructionResult::INSTRUCTION_TRAP, TrapKind::TRAP_MUTATE_STATIC);
-        senderAddress = context->address;
+        senderAddress = state.context.address;
         receiveAddress = codeAddress;
         codeExecutionAddress = codeAddress;
-        hasBalance = external->balance(context->address, pendingState) >= value;
+        hasBalance = state.external->balance(state.context.address, state.pendingState) >= value;
         callType = CallType::ACTION_CALL;
         break;
       }
     case Opcode::CALLCODE:
       {
-        senderAddress = context->address;
-        receiveAddress = context->address;
-        codeExecutionAddress = context->address;
-        hasBalance = external->balance(context->address, pendingState) >= value;
+        senderAddress = state.context.address;
+        receiveAddress = state.context.address;
+        codeExecutionAddress = state.context.address;
+        hasBalance = state.external->balance(state.context.address, state.pendingState) >= value;
         callType = CallType::ACTION_CALL;
         break;
       }
     case Opcode::DELEGATECALL:
       {
-        senderAddress = context->sender;
-        receiveAddress = context->address;
-        codeExecutionAddress = context->codeAddress;
+        senderAddress = state.context.sender;
+        receiveAddress = state.context.address;
+        codeExecutionAddress = state.context.codeAddress;
         hasBalance = true;
         callType = CallType::ACTION_CALL;
         break;
       }
     case Opcode::STATICCALL:
       {
-        senderAddress = context->address;
+        senderAddress = state.context.address;
         receiveAddress = codeAddress;
         codeExecutionAddress = codeAddress;
         hasBalance = true;
@@ -486,78 +831,96 @@ instruction_result_t VM::executeCallInstruction(
       }
   }
 
-  returnData.clear();
+  state.returnData.clear();
 
   uint64_t stipend = (value > 0) ? CALL_STIPEND : 0;
   gas_t callGas = providedGas;
   callGas = Overflow::add(callGas, stipend).first;
 
-  if (!hasBalance || stackDepth > STACK_LIMIT) {
-    stack->push(UINT256_ZERO);
+  if (!hasBalance || state.stackDepth > STACK_LIMIT) {
+    state.stack.push(UINT256_ZERO);
     return std::make_pair(InstructionResult::UNUSED_GAS, callGas);
   }
 
-  std::shared_ptr<bytes_t> callData = std::make_shared<bytes_t>(memory->readSlice(inOffset, inSize));
-  std::shared_ptr<bytes_t> code = std::make_shared<bytes_t>(external->code(codeAddress, pendingState));
-
-  std::shared_ptr<Context> callContext = Context::makeInnerCall(
-    context,
-    codeExecutionAddress,
-    codeAddress, 
-    receiveAddress, 
-    senderAddress, 
-    callGas, 
-    context->gasPrice, 
-    value, 
-    isStatic,
-    code,
-    callData
-  ); 
-
-  std::shared_ptr<Memory> callMemory = std::make_shared<Memory>();
-
-  call_result_t callResult = Call::call(
-    stackDepth,
-    callType,
-    callMemory,
-    callContext,
-    operation,
-    gasCalculation,
-    external,
-    pendingState
-  );
+  std::shared_ptr<bytes_t> callData = std::make_shared<bytes_t>(state.memory.readSlice(inOffset, inSize));
+  Memory& callMemory = state.pendingState->frames.memory(state.stackDepth + 1);
+  call_result_t callResult;
+
+  if (Precompile::exists(codeAddress)) {
+    callResult = Call::precompile(
+      state.stackDepth,
+      callType,
+      callMemory,
+      codeAddress,
+      senderAddress,
+      receiveAddress,
+      value,
+      callGas,
+      *callData,
+      state.external,
+      state.pendingState
+    );
+  } else {
+    std::shared_ptr<bytes_t> code = std::make_shared<bytes_t>(state.external->code(codeAddress, state.pendingState));
+
+    Context callContext = Context::makeInnerCall(
+      state.context,
+      codeExecutionAddress,
+      codeAddress, 
+      receiveAddress, 
+      senderAddress, 
+      callGas, 
+      state.context.gasPrice, 
+      value, 
+      isStatic,
+      state.external->codeHash(codeAddress, state.pendingState),
+      code,
+      callData
+    ); 
+
+    callResult = Call::call(
+      state.stackDepth,
+      callType,
+      callMemory,
+      callContext,
+      operation,
+      gasCalculation,
+      state.external,
+      state.pendingState
+    );
+  }
 
   switch (callResult.first) {
     case MESSAGE_CALL_SUCCESS:
       {
-        stack->push(UINT256_ONE);
+        state.stack.push(UINT256_ONE);
         gas_t gasLeft = std::get<gas_t>(callResult.second);
         return std::make_pair(InstructionResult::UNUSED_GAS, gasLeft);
       }
     case MESSAGE_CALL_RETURN:
       {
         MessageCallReturn callReturn = std::get<MessageCallReturn>(callResult.second);
-        returnData = callMemory->readSlice(callReturn.offset, callReturn.size);
-        memory->writeSlice(outOffset, outSize, returnData);
-        stack->push(UINT256_ONE);
+        state.returnData = callMemory.readSlice(callReturn.offset, callReturn.size);
+        state.memory.writeSlice(outOffset, std::min<uint64_t>(outSize, state.returnData.size()), state.returnData);
+        state.stack.push(UINT256_ONE);
         return std::make_pair(InstructionResult::UNUSED_GAS, callReturn.gasLeft);
       }
     case MESSAGE_CALL_REVERTED:
       {
         MessageCallReturn callReturn = std::get<MessageCallReturn>(callResult.second);
-        stack->push(UINT256_ZERO);
-        returnData = callMemory->readSlice(callReturn.offset, callReturn.size);
-        memory->writeSlice(outOffset, outSize, returnData);
+        state.stack.push(UINT256_ZERO);
+        state.returnData = callMemory.readSlice(callReturn.offset, callReturn.size);
+        state.memory.writeSlice(outOffset, std::min<uint64_t>(outSize, state.returnData.size()), state.returnData);
         return std::make_pair(InstructionResult::UNUSED_GAS, callReturn.gasLeft);
       }
     case MESSAGE_CALL_OUT_OF_GAS:
     {
-        stack->push(UINT256_ZERO);
+        state.stack.push(UINT256_ZERO);
         return std::make_pair(InstructionResult::OK, 0);      
     }
     case MESSAGE_CALL_FAILED:
       {
-        stack->push(UINT256_ZERO);
+        state.stack.push(UINT256_ZERO);
         return std::make_pair(InstructionResult::OK, 0);
       }
   }